@@ -24,10 +24,20 @@ namespace detail {
         double pre_velocity_magnitude_;
         double post_velocity_magnitude_;
 
+        // Outcome of the acceleration check and the increase of the pre blend distance over the requested one
+        BlendFallbackResult fallback_result_ = WITHIN_LIMITS;
+        double blend_distance_increase_ = 0.0;
+
+        // Blend distances for TrajectoryGenerator::getDebugInfo, the pre blend distance before the fallback
+        double requested_blend_distance_ = 0.0;
+        double pre_blend_distance_ = 0.0;
+        double post_blend_distance_ = 0.0;
+
     public:
         BlendSegment(Section& pre_section_ref, Section& post_section_ref, SegmentConstraint constraint,
-                     double pre_vel_mag, double post_vel_mag, double duration, double t_start)
-            : Segment(duration, t_start)
+                     double pre_vel_mag, double post_vel_mag, double duration, double t_start,
+                     const Point::allocator_type& alloc = {})
+            : Segment(duration, t_start, alloc)
             , pre_section_(pre_section_ref)
             , post_section_(post_section_ref)
             , constraint_(constraint)
@@ -45,18 +55,38 @@ namespace detail {
         void setPreBlendVelocityMagnitude(double value) { pre_velocity_magnitude_ = value; }
         void setPostBlendVelocityMagnitude(double value) { post_velocity_magnitude_ = value; }
 
+        const SegmentConstraint& getConstraint() const { return constraint_; }
+
+        void setFallbackResult(BlendFallbackResult result, double distance_increase)
+        {
+            fallback_result_ = result;
+            blend_distance_increase_ = distance_increase;
+        }
+        BlendFallbackResult getFallbackResult() const { return fallback_result_; }
+        double getBlendDistanceIncrease() const { return blend_distance_increase_; }
+
+        void setBlendDistances(double requested_distance, double pre_distance, double post_distance)
+        {
+            requested_blend_distance_ = requested_distance;
+            pre_blend_distance_ = pre_distance;
+            post_blend_distance_ = post_distance;
+        }
+        double getRequestedBlendDistance() const { return requested_blend_distance_; }
+        double getPreBlendDistance() const { return pre_blend_distance_; }
+        double getPostBlendDistance() const { return post_blend_distance_; }
+
         double getPreBlendVelocityMagnitude() const { return pre_velocity_magnitude_; }
         double getPostBlendVelocityMagnitude() const { return post_velocity_magnitude_; }
 
         void setDuration(double duration) { duration_ = duration; }
-        void setStartTime(double t_start) { start_time_ = t_start; }
 
         void setStartPoint(const Point& p) { start_point_ = p; }
         void setEndPoint(const Point& p) { end_point_ = p; }
+        // Without a copy if p uses the memory resource of the segment
+        void setStartPoint(Point&& p) { start_point_ = std::move(p); }
+        void setEndPoint(Point&& p) { end_point_ = std::move(p); }
 
-        double getStartTime() const { return start_time_; }
         double getDuration() const { return duration_; }
-        double getEndTime() const { return start_time_ + duration_; }
 
         const Point& getStartPoint() const { return start_point_; }
         const Point& getEndPoint() const { return end_point_; }
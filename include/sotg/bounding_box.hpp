@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SOTG {
+
+// Axis aligned box over the first values of the DoF, empty until it is extended
+struct BoundingBox {
+    std::vector<double> min;
+    std::vector<double> max;
+
+    BoundingBox() = default;
+    explicit BoundingBox(size_t num_dof);
+
+    size_t getNumDoF() const { return min.size(); }
+    bool isEmpty() const;
+
+    void extend(const BoundingBox& other);
+    // Exact bounds of pos + vel * t + acc * t^2 / 2 for t in [0, duration], the extremum of every DoF is closed
+    // form
+    void extendByQuadratic(const double* pos, const double* vel, const double* acc, double duration);
+
+    // Zero inside the box
+    double calcSquaredDistance(const double* point) const;
+    bool intersects(const BoundingBox& other) const;
+};
+
+}  // namespace SOTG
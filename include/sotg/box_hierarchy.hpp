@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "sotg/bounding_box.hpp"
+
+namespace SOTG {
+namespace detail {
+
+    // Balanced bounding volume hierarchy over items in order of time, shared by the distance query and the segment
+    // bounds. Every node stores the box and the time interval of its items, so traversals prune by time and by a
+    // test of the box. Items are any type with start_time, end_time and box members.
+    class BoxHierarchy {
+    public:
+        // Items per leaf
+        static constexpr size_t LEAF_SIZE = 4;
+        // Nodes waiting on the traversal stack, the hierarchy is balanced so its depth is logarithmic in the items
+        static constexpr size_t MAX_STACK_SIZE = 128;
+
+        struct Node {
+            BoundingBox box;
+            double start_time;
+            double end_time;
+            // Children for inner nodes, the items [first_item, end_item) for leafs
+            size_t left_child = 0;
+            size_t right_child = 0;
+            size_t first_item = 0;
+            size_t end_item = 0;
+            bool is_leaf = false;
+        };
+
+    private:
+        std::vector<Node> nodes_;
+
+        template <typename Item>
+        size_t buildNode(const std::vector<Item>& items, size_t num_dof, size_t first_item, size_t end_item);
+
+    public:
+        // The items have to be in order of their start time, all boxes over num_dof values
+        template <typename Item>
+        void build(const std::vector<Item>& items, size_t num_dof);
+
+        bool isEmpty() const { return nodes_.empty(); }
+        const Node& getRoot() const { return nodes_.front(); }
+
+        // Depth first traversal of the nodes whose time interval overlaps [start_time, end_time] and whose box
+        // accept_box accepts. visit_leaf gets the item range of every such leaf. At inner nodes the right child
+        // is visited first if visit_right_first returns true for the boxes of the left and right child, otherwise
+        // the items are visited in order of time. Does not allocate.
+        template <typename AcceptBox, typename VisitLeaf, typename VisitRightFirst>
+        void traverse(double start_time, double end_time, AcceptBox accept_box, VisitLeaf visit_leaf,
+                      VisitRightFirst visit_right_first) const;
+    };
+
+    template <typename Item>
+    void BoxHierarchy::build(const std::vector<Item>& items, size_t num_dof)
+    {
+        nodes_.clear();
+        if (!items.empty()) {
+            nodes_.reserve(2 * (items.size() / LEAF_SIZE + 1));
+            buildNode(items, num_dof, 0, items.size());
+        }
+    }
+
+    template <typename Item>
+    size_t BoxHierarchy::buildNode(const std::vector<Item>& items, size_t num_dof, size_t first_item,
+                                   size_t end_item)
+    {
+        size_t index = nodes_.size();
+        nodes_.emplace_back();
+        nodes_[index].box = BoundingBox(num_dof);
+        nodes_[index].start_time = items[first_item].start_time;
+        nodes_[index].end_time = items[end_item - 1].end_time;
+
+        if (end_item - first_item <= LEAF_SIZE) {
+            for (size_t i = first_item; i < end_item; ++i) {
+                nodes_[index].box.extend(items[i].box);
+                nodes_[index].end_time = std::max(nodes_[index].end_time, items[i].end_time);
+            }
+            nodes_[index].first_item = first_item;
+            nodes_[index].end_item = end_item;
+            nodes_[index].is_leaf = true;
+            return index;
+        }
+
+        // Splitting in the middle of the time order keeps the hierarchy balanced and its nodes contiguous in time
+        size_t middle = first_item + (end_item - first_item) / 2;
+        size_t left_child = buildNode(items, num_dof, first_item, middle);
+        size_t right_child = buildNode(items, num_dof, middle, end_item);
+        nodes_[index].left_child = left_child;
+        nodes_[index].right_child = right_child;
+        nodes_[index].box.extend(nodes_[left_child].box);
+        nodes_[index].box.extend(nodes_[right_child].box);
+        nodes_[index].end_time = std::max(nodes_[left_child].end_time, nodes_[right_child].end_time);
+        return index;
+    }
+
+    template <typename AcceptBox, typename VisitLeaf, typename VisitRightFirst>
+    void BoxHierarchy::traverse(double start_time, double end_time, AcceptBox accept_box, VisitLeaf visit_leaf,
+                                VisitRightFirst visit_right_first) const
+    {
+        if (nodes_.empty() || end_time < start_time) {
+            return;
+        }
+
+        std::array<size_t, MAX_STACK_SIZE> stack;
+        size_t stack_size = 0;
+        stack[stack_size++] = 0;
+        while (stack_size > 0) {
+            const Node& node = nodes_[stack[--stack_size]];
+            if (node.end_time < start_time || node.start_time > end_time || !accept_box(node.box)) {
+                continue;
+            }
+
+            if (node.is_leaf) {
+                visit_leaf(node.first_item, node.end_item);
+                continue;
+            }
+
+            // The child pushed last is visited first
+            if (stack_size + 2 > MAX_STACK_SIZE) {
+                throw std::runtime_error("BoxHierarchy: The hierarchy is too deep");
+            }
+            if (visit_right_first(nodes_[node.left_child].box, nodes_[node.right_child].box)) {
+                stack[stack_size++] = node.left_child;
+                stack[stack_size++] = node.right_child;
+            } else {
+                stack[stack_size++] = node.right_child;
+                stack[stack_size++] = node.left_child;
+            }
+        }
+    }
+
+}  // namespace detail
+}  // namespace SOTG
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cmath>
 #include <limits>
 #include <stdexcept>
@@ -16,41 +17,78 @@
 namespace SOTG {
 namespace detail {
 
+    // Storage of per DoF values inside the solver, fixed size and on the stack if the number of DoF is known at
+    // compile time
+    template <int NumDoF>
+    struct DoFStorage {
+        static_assert(NumDoF > 0, "The number of DoF has to be positive or DYNAMIC_DOF");
+        using Vector = std::array<double, NumDoF>;
+    };
+
+    template <>
+    struct DoFStorage<DYNAMIC_DOF> {
+        using Vector = std::vector<double>;
+    };
+
     // Implements the logic for section and segment generation aswell as the
     // calculation of positions and velocities for specific points in time using a
-    // bang coast bang profile
+    // bang coast bang profile. With NumDoF != DYNAMIC_DOF the per DoF loops of the section calculation have a
+    // compile time bound and work on stack arrays
+    template <int NumDoF = DYNAMIC_DOF>
     class ConstantAccelerationSolver : public KinematicSolver {
     private:
+        using DoFVector = typename DoFStorage<NumDoF>::Vector;
+        // Size of the Eigen views of points, fixed if the number of DoF is known at compile time
+        static constexpr int VECTOR_SIZE = NumDoF == DYNAMIC_DOF ? Eigen::Dynamic : NumDoF;
+
         size_t current_section_id{0};
         size_t current_segment_id{0};
 
+        // Scratch storage of the blend calculation, keeps its capacity from one blend to the next
+        Point blend_velocity_;
+        Point candidate_start_point_;
+        Point candidate_end_point_;
+
         void calcSegmentPreparations(const Section& pre_section, const Section& post_section,
-                                     std::vector<double>& a_max_post, std::vector<double>& a_max_pre,
                                      double& L_acc_magnitude_post, double& T_acc_post, double& T_acc_pre);
 
-        void calcAccAndVelPerDoF(const Section& section, std::vector<double>& a_max_vec,
-                                 std::vector<double>& v_max_vec);
+        // Replaces the angular part of the section difference by the rotation vector between its waypoints
+        void setRotationVectorDifference(Section& section);
+
+        // Angles the waypoints would have at the same progress with component wise interpolation, used to unwrap
+        // the angles calculated from quaternions consistently with the waypoints
+        Eigen::Vector3d calcEulerReference(const Section& section, const Point& pos_path_space) const;
+
+        // Number of DoF of the section, throws if it does not match a fixed NumDoF
+        static size_t getNumDoF(const Section& section);
+        static DoFVector makeDoFVector(size_t num_dof);
+
+        void calcAccAndVelPerDoF(const Section& section, DoFVector& a_max_vec, DoFVector& v_max_vec);
 
         void calcPhaseTimeAndDistance(double& a_max, double& v_max, double L_total, PhaseDoF& acc_phase_single_dof,
                                       PhaseDoF& coast_phase_single_dof, PhaseDoF& dec_phase_single_dof);
 
-        void calcTotalTimeAndDistanceSingleDoF(double& a_max, double& v_max, double total_length,
-                                               double& total_time, size_t coordinate_id);
+        // Duration of the profile of a single DoF, reduces v_max if the DoF can not reach it
+        static double calcTotalTimeSingleDoF(double a_max, double& v_max, double total_length);
 
-        void calcTimesAndLengthsMultiDoF(Phase& acc_phase, Phase& coast_phase, Phase& dec_phase,
-                                         std::vector<double>& total_time_per_dof,
-                                         std::vector<double>& total_length_per_dof, Point diff,
-                                         std::vector<double>& a_max_vec, std::vector<double>& v_max_vec);
+        // Fills the synchronized phases in place, without per DoF temporaries. All DoF share the duration
+        // total_time, returns the index of the longest DoF that sets it.
+        size_t calcSyncedPhases(const Point& diff, DoFVector& a_max_vec, DoFVector& v_max_vec, Phase& acc_phase,
+                                Phase& coast_phase, Phase& dec_phase, double& total_time);
 
         void calcSecondBlendingDist(double T_blend, double T_acc_post, double a_max_magnitude_post,
                                     double vel_pre_blend_magnitude, double blending_dist_pre,
-                                    double& blending_dist_post, size_t segment_id);
+                                    double& blending_dist_post, size_t segment_id, bool log_records);
 
         void calcPosAndVelSingleDoFLinear(double section_length, const Phase& phase,
                                           double phase_distance_to_p_start, double t_phase, double a_max_reduced,
                                           double v_max_reduced, double& pos_magnitude,
                                           double& vel_magnitude) const;
-        void calcVelAndTimeByDistance(const Section& section, double distance, Point& velocity_per_dof,
+        // Like calcPosAndVelSection, but angular values stay in the space the section was planned in
+        void calcPosAndVelSectionPathSpace(double t_section, const Section& section, Point& pos, Point& vel) const;
+
+        // Magnitude of the velocity and absolute time at which the section reaches distance
+        void calcVelAndTimeByDistance(const Section& section, double distance, double& velocity_magnitude,
                                       double& time_when_distance_is_reached);
 
         void calcPreBlendParams(double blending_dist_pre, const Section& pre_section, Point& A_blend,
@@ -60,14 +98,18 @@ namespace detail {
         void calcPostBlendParams(double blending_dist_pre, const Section& pre_section, Point& C_blend,
                                  double& T_blend, double& vel_pre_blend_magnitude, double& t_abs_start_blend);
 
-        bool isBlendAccelerationTooHigh(const std::vector<double>& a_max, const double& T_blend,
+        bool isBlendAccelerationTooHigh(const std::pmr::vector<double>& a_max, const double& T_blend,
                                         const double& vel_pre_blend_magnitude,
                                         const double& vel_post_blend_magnitude, const Section& pre_section,
-                                        const Section& post_section, size_t segment_id);
+                                        const Section& post_section, size_t segment_id, bool log_warnings = true);
         void setNoBlendingParams(const Section& pre_section, const Section& post_section, double& T_blend,
                                  double& absolute_blend_start_time_with_shift,
                                  double& absolute_blend_end_time_without_shift, Point& A_blend, Point& C_blend,
                                  double& vel_pre_blend_magnitude, double& vel_post_blend_magnitude);
+        // Shared by calcBlendSegment and calcBlendParameters, also sets the start and end point of the blend
+        void calcBlend(const Section& pre_section, const Section& post_section, const SegmentConstraint& constraint,
+                       size_t segment_id, BlendFallback fallback, bool log_warnings, BlendParameters& params,
+                       Point& A_blend, Point& C_blend);
 
     public:
         ConstantAccelerationSolver(const Logger& logger)
@@ -78,8 +120,11 @@ namespace detail {
         Section calcSection(Point& p_start_ref, Point& p_end_ref, SectionConstraint constraint_copy,
                             size_t section_id) override;
         std::shared_ptr<BlendSegment> calcBlendSegment(Section& pre_section, Section& post_section,
-                                                       const SegmentConstraint& constraint, size_t segment_id,
-                                                       std::map<std::string, double>& debug_output) override;
+                                                       const SegmentConstraint& constraint,
+                                                       size_t segment_id) override;
+        BlendParameters calcBlendParameters(const Section& pre_section, const Section& post_section,
+                                            const SegmentConstraint& constraint, size_t segment_id,
+                                            bool log_warnings) override;
 
         void calcPosAndVelSection(double t_section, const Section& section, Point& pos, Point& vel) const override;
 
@@ -88,6 +133,23 @@ namespace detail {
 
         void calcPosAndVelBlendSegment(double t_segment, const BlendSegment& segment, Point& pos,
                                        Point& vel) const override;
+
+        void calcStop(double t_section, double t_segment, const Segment& segment,
+                      StopTrajectory& stop) const override;
     };
+
+    // Largest number of DoF a fixed size solver is instantiated for in the library
+    constexpr int MAX_FIXED_DOF = 9;
+
+    extern template class ConstantAccelerationSolver<DYNAMIC_DOF>;
+    extern template class ConstantAccelerationSolver<1>;
+    extern template class ConstantAccelerationSolver<2>;
+    extern template class ConstantAccelerationSolver<3>;
+    extern template class ConstantAccelerationSolver<4>;
+    extern template class ConstantAccelerationSolver<5>;
+    extern template class ConstantAccelerationSolver<6>;
+    extern template class ConstantAccelerationSolver<7>;
+    extern template class ConstantAccelerationSolver<8>;
+    extern template class ConstantAccelerationSolver<9>;
 }  // namespace detail
 }  // namespace SOTG
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "sotg/bounding_box.hpp"
+#include "sotg/box_hierarchy.hpp"
+
+namespace SOTG {
+
+struct DistanceQueryResult {
+    // Infinite if no point came closer than the bound of the query
+    double distance = std::numeric_limits<double>::infinity();
+    // Time of the closest approach and the index of the point it approaches
+    double time = 0.0;
+    size_t point_index = 0;
+
+    bool isFound() const { return distance < std::numeric_limits<double>::infinity(); }
+};
+
+// Closest approach of the planned motion to a set of points, see TrajectoryGenerator::buildDistanceQuery. The
+// motion consists of pieces of constant acceleration, the straight sections and parabolic blends, whose closest
+// approach to a point is a root of a cubic. A bounding volume hierarchy over the pieces in order of time prunes
+// pieces outside the time window and pieces farther away than the closest approach found so far.
+class DistanceQuery {
+private:
+    // Pieces in order of time, the start state and acceleration of their positions one after the other
+    struct Piece {
+        double start_time;
+        double end_time;
+        BoundingBox box;
+        size_t coefficient_index;
+    };
+
+    size_t num_dof_ = 0;
+    std::vector<Piece> pieces_;
+    std::vector<double> coefficients_;
+    detail::BoxHierarchy hierarchy_;
+
+public:
+    DistanceQuery() = default;
+    explicit DistanceQuery(size_t num_dof);
+
+    // Pieces have to be added in order of time, pos, vel and acc hold getNumDoF positions each
+    void addPiece(double start_time, double end_time, const double* pos, const double* vel, const double* acc);
+    // Builds the hierarchy over the added pieces, needed before the first query
+    void build();
+
+    size_t getNumDoF() const { return num_dof_; }
+    size_t getNumPieces() const { return pieces_.size(); }
+
+    // points holds getNumDoF values per point. Only approaches within [start_time, end_time] and closer than
+    // max_distance are searched, a finite max_distance turns it into a tolerance check. Does not allocate.
+    DistanceQueryResult findClosestApproach(const std::vector<double>& points, double start_time,
+                                            double end_time,
+                                            double max_distance = std::numeric_limits<double>::infinity()) const;
+};
+
+}  // namespace SOTG
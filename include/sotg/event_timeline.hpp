@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SOTG {
+
+enum TrajectoryEventType {
+    WAYPOINT_REACHED,  // The trajectory passes its corner, when getNumPassedWaypoints counts it
+    BLEND_START,
+    BLEND_END,
+    PHASE_CHANGE  // A linear segment switches between accelerating, coasting and decelerating
+};
+
+enum TrajectoryPhase { ACCELERATING, COASTING, DECELERATING };
+
+struct TrajectoryEvent {
+    TrajectoryEventType type;
+    // Exact time of the event, independent of the sample period it is fired with
+    double time;
+    // The waypoint that is reached, the corner of a blend or the end waypoint of the section a phase belongs to
+    int waypoint_id;
+    size_t section_id;
+    // Phase that begins with a PHASE_CHANGE
+    TrajectoryPhase phase;
+};
+
+// Receives the events fired by EventTimeline::advance
+class EventListener {
+public:
+    virtual void onEvent(const TrajectoryEvent& event) = 0;
+
+    virtual ~EventListener() = default;
+};
+
+// Events of a planned trajectory in order of their time with a cursor that is advanced every tick, see
+// TrajectoryGenerator::buildEventTimeline. Advancing costs constant time plus the events it fires, instead of a
+// search of the sections every tick.
+class EventTimeline {
+private:
+    std::vector<TrajectoryEvent> events_;
+    size_t next_event_ = 0;
+
+public:
+    EventTimeline() = default;
+    // Sorts the events by time, events at the same time keep their order
+    explicit EventTimeline(std::vector<TrajectoryEvent> events);
+
+    // Fires all events up to and including time that were not fired yet and returns their number
+    size_t advance(double time, EventListener& listener);
+    // Moves the cursor so that the next advance fires the events after time, e.g. after jumping back in time
+    void seek(double time);
+
+    const std::vector<TrajectoryEvent>& getEvents() const { return events_; }
+    size_t getNumPendingEvents() const { return events_.size() - next_event_; }
+};
+
+}  // namespace SOTG
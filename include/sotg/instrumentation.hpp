@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace SOTG {
+
+// Operations whose call counts and latencies are recorded if SOTG is built with INSTRUMENTATION defined
+enum InstrumentedOperation {
+    CALC_SECTION,
+    CALC_BLEND_SEGMENT,
+    GENERATE_LINEAR_SEGMENTS,
+    SECTION_LOOKUP,
+    SEGMENT_LOOKUP,
+    EVALUATION,
+    NUM_INSTRUMENTED_OPERATIONS
+};
+
+// Latency histogram with power of two buckets, bucket i counts latencies up to 2^(i + 6) ns, the last bucket is
+// open ended
+class LatencyHistogram {
+public:
+    static constexpr size_t NUM_BUCKETS = 24;
+
+private:
+    std::array<uint64_t, NUM_BUCKETS> bucket_counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ns_ = 0;
+    uint64_t min_ns_ = 0;
+    uint64_t max_ns_ = 0;
+
+public:
+    void record(uint64_t latency_ns);
+    void reset();
+
+    uint64_t getCount() const { return count_; }
+    uint64_t getSumNs() const { return sum_ns_; }
+    uint64_t getMinNs() const { return min_ns_; }
+    uint64_t getMaxNs() const { return max_ns_; }
+    double getMeanNs() const;
+    uint64_t getBucketCount(size_t bucket) const { return bucket_counts_.at(bucket); }
+    static uint64_t getBucketUpperBoundNs(size_t bucket);
+
+    // Upper bound of the bucket the given quantile (0.0 to 1.0) falls into, the maximum for the last bucket
+    uint64_t getQuantileUpperBoundNs(double quantile) const;
+};
+
+// Counters and latency histograms of the planning and evaluation steps. Nothing is recorded unless the library
+// is built with INSTRUMENTATION defined, the query API is always available.
+class Instrumentation {
+private:
+    std::array<LatencyHistogram, NUM_INSTRUMENTED_OPERATIONS> histograms_;
+
+public:
+    // Whether the library was built with instrumentation
+    static bool isEnabled();
+    static std::string getOperationName(InstrumentedOperation operation);
+
+    void record(InstrumentedOperation operation, uint64_t latency_ns) { histograms_[operation].record(latency_ns); }
+    const LatencyHistogram& getHistogram(InstrumentedOperation operation) const { return histograms_.at(operation); }
+    void reset();
+
+    // Prometheus text exposition format, one histogram per operation with the latencies in seconds
+    std::string toPrometheus() const;
+    void writePrometheus(const std::string& file_name) const;
+};
+
+namespace detail {
+
+    // Records the lifetime of the object as one call of the operation
+    class ScopedTimer {
+    private:
+        Instrumentation& instrumentation_;
+        InstrumentedOperation operation_;
+        std::chrono::steady_clock::time_point start_;
+
+    public:
+        ScopedTimer(Instrumentation& instrumentation, InstrumentedOperation operation)
+            : instrumentation_(instrumentation)
+            , operation_(operation)
+            , start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - start_;
+            instrumentation_.record(operation_, latency.count());
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    };
+
+}  // namespace detail
+}  // namespace SOTG
+
+#ifdef INSTRUMENTATION
+#define SOTG_INSTRUMENT_SCOPE(instrumentation, operation)                                                         \
+    ::SOTG::detail::ScopedTimer sotg_scoped_timer_(instrumentation, operation)
+#else
+#define SOTG_INSTRUMENT_SCOPE(instrumentation, operation)                                                         \
+    do {                                                                                                          \
+    } while (false)
+#endif
@@ -1,17 +1,42 @@
 #pragma once
 
-#include <map>
+#include <memory_resource>
 #include <memory>
-#include <string>
 
 #include "sotg/blend_segment.hpp"
 #include "sotg/linear_segment.hpp"
 #include "sotg/logger.hpp"
+#include "sotg/orientation.hpp"
 #include "sotg/section.hpp"
 #include "sotg/segment.hpp"
+#include "sotg/segment_constraint.hpp"
+#include "sotg/stop_trajectory.hpp"
+#include "sotg/tracing.hpp"
 
 namespace SOTG {
+// Number of DoF used if it is only known at runtime
+constexpr int DYNAMIC_DOF = -1;
+
+// Tag type to select a solver specialized for a number of DoF known at compile time
+template <int NumDoF>
+struct FixedDoF {
+};
+
 namespace detail {
+    // A blend without its segment, see KinematicSolver::calcBlendParameters
+    struct BlendParameters {
+        double requested_pre_blend_distance = 0.0;
+        double pre_blend_distance = 0.0;
+        double post_blend_distance = 0.0;
+        double pre_velocity_magnitude = 0.0;
+        double post_velocity_magnitude = 0.0;
+        double duration = 0.0;
+        // Start of the blend with the time shift of the pre section and the time shift it gives the post section
+        double start_time = 0.0;
+        double time_shift = 0.0;
+        BlendFallbackResult fallback_result = WITHIN_LIMITS;
+    };
+
     // Derived classes of this base class implement the logic for section and
     // segment generation aswell as the calculation of position and velocity for a
     // specific point in time
@@ -19,18 +44,41 @@ namespace detail {
     protected:
         const Logger& logger_;
 
+        OrientationInterpolation orientation_interpolation_ = COMPONENT_WISE;
+
+        Tracer* tracer_ = nullptr;
+
+        BlendFallback blend_fallback_ = STOP_AT_CORNER;
+
+        // Sections and blend segments are allocated from this resource
+        std::pmr::memory_resource* memory_resource_ = std::pmr::get_default_resource();
+
     public:
         KinematicSolver(const Logger& logger)
             : logger_(logger)
         {
         }
 
+        void setOrientationInterpolation(OrientationInterpolation type) { orientation_interpolation_ = type; }
+        OrientationInterpolation getOrientationInterpolation() const { return orientation_interpolation_; }
+
+        void setTracer(Tracer* tracer) { tracer_ = tracer; }
+        void setBlendFallback(BlendFallback fallback) { blend_fallback_ = fallback; }
+        void setMemoryResource(std::pmr::memory_resource* resource) { memory_resource_ = resource; }
+
         virtual Section calcSection(Point& p_start_ref, Point& p_end_ref, SectionConstraint constraint_copy,
                                     size_t section_id)
             = 0;
         virtual std::shared_ptr<BlendSegment>
         calcBlendSegment(Section& pre_section, Section& post_section, const SegmentConstraint& constraint,
-                         size_t segment_id, std::map<std::string, double>& debug_output)
+                         size_t segment_id)
+            = 0;
+        // Blend of the requested distance like calcBlendSegment, but neither a segment is allocated nor the time
+        // shift of the post section set. A blend that exceeds the limits stops at the corner regardless of the
+        // blend fallback. Nothing is logged without log_warnings, e.g. for candidates of the blend optimization.
+        virtual BlendParameters calcBlendParameters(const Section& pre_section, const Section& post_section,
+                                                    const SegmentConstraint& constraint, size_t segment_id,
+                                                    bool log_warnings)
             = 0;
 
         virtual void calcPosAndVelSection(double t_section, const Section& section, Point& pos,
@@ -42,6 +90,11 @@ namespace detail {
         virtual void calcPosAndVelBlendSegment(double t_segment, const BlendSegment& segment, Point& pos,
                                                Point& vel) const = 0;
 
+        // Adds the pieces of a stop along the path from the state at t_section and t_segment to stop, must not
+        // allocate
+        virtual void calcStop(double t_section, double t_segment, const Segment& segment,
+                              StopTrajectory& stop) const = 0;
+
         virtual ~KinematicSolver() = default;
     };
 }  // namespace detail
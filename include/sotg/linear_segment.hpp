@@ -17,8 +17,8 @@ namespace detail {
         Section& section_;
 
     public:
-        LinearSegment(Section& section, double duration, double t_start)
-            : Segment(duration, t_start)
+        LinearSegment(Section& section, double duration, double t_start, const Point::allocator_type& alloc = {})
+            : Segment(duration, t_start, alloc)
             , section_(section)
         {
         }
@@ -27,14 +27,11 @@ namespace detail {
                            Point& vel, const KinematicSolver& solver) const override;
 
         void setDuration(double duration) { duration_ = duration; }
-        void setStartTime(double t_start) { start_time_ = t_start; }
 
         void setStartPoint(const Point& p) { start_point_ = p; }
         void setEndPoint(const Point& p) { end_point_ = p; }
 
-        double getStartTime() const { return start_time_; }
         double getDuration() const { return duration_; }
-        double getEndTime() const { return start_time_ + duration_; }
 
         const Point& getStartPoint() const { return start_point_; }
         const Point& getEndPoint() const { return end_point_; }
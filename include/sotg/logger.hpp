@@ -1,9 +1,13 @@
 #pragma once
 
+#include <array>
 #include <iostream>
+#include <string>
 
 namespace SOTG {
 
+struct LogRecord;
+
 /*The Logger class can be used in order to pass SOTG internal warnings and debugging info to the user instead
  * of printing them to directly to cout*/
 class Logger {
@@ -12,7 +16,44 @@ public:
 
     virtual void log(const std::string& message, MsgType type = INFO) const;
 
+    // Whether messages of the type are passed on at all, records of disabled types are not formatted. By default
+    // only with VERBOSE defined, like log prints them. Loggers that override log override this as well, otherwise
+    // they receive no records without VERBOSE.
+    virtual bool isEnabled(MsgType type) const;
+
+    // The planner reports through records instead of formatted messages. By default enabled records are
+    // formatted with formatLogRecord and passed to log, loggers that must not block override this to format them
+    // later.
+    virtual void logRecord(const LogRecord& record) const;
+
     virtual ~Logger() = default;
 };
 
-}  // namespace SOTG
\ No newline at end of file
+// What a log record reports, the values of the record depend on the event
+enum LogEvent {
+    SECTION_VELOCITY_DECREASED,          // values: number of DoF whose maximum velocity is decreased, which are all
+                                         // moving DoF of the section, and the fraction of the velocity they keep
+    BLEND_INTO_ACCELERATION_PHASE,       // The post blend distance is calculated within the acceleration phase
+    BLEND_INTO_CONSTANT_VELOCITY_PHASE,  // and here within the constant velocity phase
+    BLEND_LINEAR_ACCELERATION_EXCEEDED,  // values: linear acceleration magnitude of the blend, allowed magnitude
+    BLEND_ANGULAR_ACCELERATION_EXCEEDED, // values: angular acceleration magnitude of the blend, allowed magnitude
+    BLEND_DOF_ACCELERATION_EXCEEDED,     // values: acceleration of the DoF during the blend, allowed acceleration
+    BLEND_DISTANCE_CROPPED,              // The pre blend distance is cropped to half the pre section
+    BLEND_DISTANCE_EXTENDED,             // values: requested blend distance, extended blend distance
+    PATH_PREPROCESSED                    // values: number of removed waypoints, number of waypoints before
+};
+
+// Compact record of a log event, trivially copyable so that it can be stored without allocating
+struct LogRecord {
+    LogEvent event;
+    Logger::MsgType type;
+    // Section or segment the event belongs to and the DoF, -1 if the event has none
+    int id = -1;
+    int dof = -1;
+    std::array<double, 2> values{};
+};
+
+// Message of the record, e.g. "[Segment Nr.3] Pre blending distance is cropped"
+std::string formatLogRecord(const LogRecord& record);
+
+}  // namespace SOTG
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/Geometry>
+
+#include "sotg/point.hpp"
+
+namespace SOTG {
+
+// Describes how the angular values of a point, all values from its orientation index on, are interpolated
+enum OrientationInterpolation {
+    // Every angle is an independent DoF, rotations are not geodesic
+    COMPONENT_WISE,
+    // The angles are roll, pitch and yaw with R = Rz(yaw) * Ry(pitch) * Rx(roll). Sections rotate along the
+    // geodesic between their waypoints, blends transition between the two rotation axes and the angular limits
+    // apply to the rotation angle. Angular velocities are returned as roll, pitch and yaw rates. Angles match the
+    // waypoints exactly but may jump by 2 pi where the geodesic runs the other way around than the angles do.
+    QUATERNION_SLERP
+};
+
+namespace detail {
+
+    // Orientation stored in the three angular values of point
+    Eigen::Quaterniond calcQuaternion(const Point& point);
+
+    // Rotation vector r (axis * angle) in the local frame of from, so that to = from * Exp(r)
+    Eigen::Vector3d calcRotationVector(const Eigen::Quaterniond& from, const Eigen::Quaterniond& to);
+
+    // Replaces the angular values of pos and vel, which hold the rotation vector r and its derivative relative to
+    // reference, by the roll, pitch and yaw angles of reference * Exp(r) and their rates. Angles are unwrapped to
+    // be closest to reference_angles, roll, pitch and yaw. Writes into pos and vel without allocating.
+    void applyRotationVector(const Eigen::Quaterniond& reference, const Eigen::Vector3d& reference_angles,
+                             Point& pos, Point& vel);
+
+}  // namespace detail
+}  // namespace SOTG
@@ -7,9 +7,36 @@
 #include <eigen3/Eigen/Core>
 
 #include "sotg/point.hpp"
+#include "sotg/section_constraint.hpp"
+#include "sotg/segment_constraint.hpp"
 
 namespace SOTG {
 
+// Tolerances used by Path::preprocess, all values are given in path space (the same space in which section
+// lengths and blend distances are measured)
+struct PreprocessingOptions {
+    // Maximum distance a removed waypoint may have to the straight line that replaces it
+    double colinear_tolerance = 1e-6;
+    // Sections shorter than this are merged into their neighbours, the removed waypoint may then deviate up to
+    // the blend distance of its corner
+    double min_section_length = 1e-3;
+    // Plan the path before and after preprocessing to report the saved cycle time
+    bool measure_cycle_time_gain = false;
+};
+
+struct PreprocessingReport {
+    size_t num_waypoints_before = 0;
+    size_t num_removed_colinear = 0;
+    size_t num_removed_short_sections = 0;
+
+    // Only filled by TrajectoryGenerator::resetPath if measure_cycle_time_gain is set
+    double duration_before = 0.0;
+    double duration_after = 0.0;
+
+    size_t getNumRemovedWaypoints() const { return num_removed_colinear + num_removed_short_sections; }
+    double getCycleTimeGain() const { return duration_before - duration_after; }
+};
+
 // A collection of points used as an input to the trajectory generator to
 // quickly setup many new waypoints
 class Path {
@@ -20,6 +47,13 @@ public:
     void addPoint(Point point);
     void addPoint(const std::vector<Eigen::VectorXd>& old_point);
     void addPoint(const std::vector<std::vector<double>>& old_point);
+    // Bulk load waypoints, every row is one waypoint and every column one DoF. The raw overload expects a
+    // row major buffer of rows * cols values. Waypoints get the ids 1 to rows. The orientation index is -1 or the
+    // first of three angular columns.
+    static Path fromMatrix(const Eigen::MatrixXd& waypoints, int orientation_index = -1);
+    static Path fromMatrix(const double* data, size_t rows, size_t cols, int orientation_index = -1);
+
+    void reserve(size_t num_waypoints) { waypoints_.reserve(num_waypoints); }
     size_t getNumWaypoints() { return waypoints_.size(); };
     Point& getPointReference(size_t index);
     Point getPointValue(size_t index) const;
@@ -27,6 +61,8 @@ public:
     size_t size() const { return waypoints_.size(); }
     std::vector<Point>::const_iterator begin() const { return waypoints_.begin(); }
     std::vector<Point>::const_iterator end() const { return waypoints_.end(); }
+    std::vector<Point>::iterator begin() { return waypoints_.begin(); }
+    std::vector<Point>::iterator end() { return waypoints_.end(); }
     std::vector<Point>::iterator erase(const std::vector<Point>::const_iterator position) { return waypoints_.erase(position); }
     std::vector<Point>::iterator erase(const std::vector<Point>::const_iterator first_elemet, const std::vector<Point>::const_iterator last_element) { return waypoints_.erase(first_elemet, last_element); }
 
@@ -39,6 +75,13 @@ public:
         std::cout << "]" << std::endl;
     }
 
+    // Merges nearly colinear waypoints and drops waypoints enclosing very short sections. The constraint
+    // vectors are shrunk accordingly, merged sections use the stricter limits of their parts. Start and end
+    // point are always kept, waypoint ids stay untouched.
+    PreprocessingReport preprocess(std::vector<SectionConstraint>& section_constraints,
+                                   std::vector<SegmentConstraint>& segment_constraints,
+                                   const PreprocessingOptions& options = PreprocessingOptions());
+
     Path operator+(const Path& path);
 
     std::ostream& operator<<(std::ostream& out);
@@ -1,57 +1,153 @@
 #pragma once
 
+#include <deque>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 #include "sotg/blend_segment.hpp"
+#include "sotg/instrumentation.hpp"
 #include "sotg/kinematic_solver.hpp"
 #include "sotg/linear_segment.hpp"
 #include "sotg/path.hpp"
 #include "sotg/section.hpp"
 #include "sotg/section_constraint.hpp"
+#include "sotg/segment_bounds.hpp"
 #include "sotg/segment_constraint.hpp"
+#include "sotg/tracing.hpp"
 
 namespace SOTG {
 namespace detail {
 
     // Stores and maintains the input path aswell as all generated sections and
-    // segments
+    // segments. Waypoints, sections and segments are allocated from the memory resource passed on construction.
     class PathManager {
     private:
-        Path path_;
-        std::list<Section> sections_;
-        std::list<std::shared_ptr<Segment>> segments_;
-
-        std::vector<SectionConstraint> section_constraints_;
-        std::vector<SegmentConstraint> segment_constraints_;
+        std::pmr::memory_resource* memory_resource_;
+
+        // A list keeps references to its elements valid when waypoints are appended, sections rely on that.
+        // Unlike a deque it holds no memory once it is empty.
+        std::pmr::list<Point> waypoints_;
+        std::pmr::list<Section> sections_;
+        std::pmr::list<std::shared_ptr<Segment>> segments_;
+        // Offsets of the timelines spliced into the path, the first one is the root timeline of the path. Every
+        // section and segment refers to one of them. They are not allocated from the memory resource, the root
+        // timeline outlives clear.
+        std::list<TimelineOffset> timelines_;
+
+        size_t next_section_id_ = 0;
+
+        // Segment found by the last lookup, the end if it was removed since
+        std::pmr::list<std::shared_ptr<Segment>>::iterator segment_lookup_hint_;
+        // Bounds of the segments, rebuilt by getSegmentBounds once the segments changed
+        SegmentBoundsTree segment_bounds_;
+        bool segment_bounds_valid_ = false;
+
+        // Lazy blending, blends are computed once the evaluated time comes within blend_look_ahead_ seconds.
+        // Sections from first_unblended_section_ on are not blended yet, it is the end without lazy blending.
+        double blend_look_ahead_ = -1.0;
+        std::pmr::list<Section>::iterator first_unblended_section_;
+        std::vector<SegmentConstraint> lazy_segment_constraints_;
+        size_t next_lazy_constraint_ = 0;
+
+        // Blend distance optimization, a negative deviation keeps the requested blend distances
+        double blend_max_deviation_ = -1.0;
+
+        // Waypoints pushed in sliding window mode that are not planned yet
+        std::deque<Point> pending_waypoints_;
+        std::deque<SectionConstraint> pending_section_constraints_;
+        std::deque<SegmentConstraint> pending_segment_constraints_;
+        SegmentConstraint last_segment_constraint_{0.0};
 
         std::shared_ptr<KinematicSolver> kinematic_solver_;
 
-        std::vector<std::map<std::string, double>>& debug_info_vec_;
-
-        void resetSections();
-        void resetSegments();
-        void generateBlendSegments();
-        void generateLinearSegments();
+        Instrumentation& instrumentation_;
+        Tracer* tracer_ = nullptr;
+
+        void resetSections(const std::vector<SectionConstraint>& section_constraints, double start_time);
+        void resetSegments(std::vector<SegmentConstraint>&& segment_constraints, double start_time);
+        void generateSections(std::pmr::list<Point>::iterator first_waypoint, double start_time,
+                              const std::vector<SectionConstraint>& section_constraints);
+        void generateBlendSegments(std::pmr::list<Section>::iterator first_post_section,
+                                   std::pmr::list<Section>::iterator end_post_section,
+                                   std::vector<SegmentConstraint>::const_iterator first_constraint,
+                                   double earliest_blend_start);
+        void generateLinearSegments(std::pmr::list<std::shared_ptr<Segment>>::iterator first_blend_segment,
+                                    double start_time);
+        // Blend distance that saves the most time while the blend stays within blend_max_deviation_ of the
+        // corner, requested zero distances are kept as exact stops. Only the chosen distance is allocated as a
+        // segment by the caller.
+        SegmentConstraint optimizeBlendDistance(const Section& pre_section, const Section& post_section,
+                                                const SegmentConstraint& requested, size_t blend_segment_id) const;
+        void appendWaypoints(Path&& new_path);
+        // Blends corners in order until the motion up to time is final
+        void blendAhead(double time);
 
     public:
-        PathManager(std::shared_ptr<KinematicSolver> solver,
-                    std::vector<std::map<std::string, double>>& debug_info_vec);
-
-        void resetPath(Path path, std::vector<SectionConstraint> section_constraints,
-                       std::vector<SegmentConstraint> segment_constraints);
+        PathManager(std::shared_ptr<KinematicSolver> solver, Instrumentation& instrumentation,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+        void setTracer(Tracer* tracer) { tracer_ = tracer; }
+
+        // A negative look ahead blends all corners in resetPath, otherwise they are blended during the lookups.
+        // Applies from the next resetPath on.
+        void setBlendLookAhead(double look_ahead) { blend_look_ahead_ = look_ahead; }
+        double getBlendLookAhead() const { return blend_look_ahead_; }
+        // A non-negative deviation replaces the requested blend distances by the ones that save the most time
+        // while every blend passes its corner within max_deviation. Applies from the next resetPath on.
+        void setBlendMaxDeviation(double max_deviation) { blend_max_deviation_ = max_deviation; }
+        double getBlendMaxDeviation() const { return blend_max_deviation_; }
+        // Blends all corners that are left from lazy blending
+        void completeBlends() { blendAhead(std::numeric_limits<double>::infinity()); }
+
+        // Takes ownership of the input, sections keep references into the stored waypoints
+        void resetPath(Path&& path, std::vector<SectionConstraint>&& section_constraints,
+                       std::vector<SegmentConstraint>&& segment_constraints);
+
+        // Continues the current path with new waypoints. One section constraint is needed per new waypoint and
+        // one segment constraint per new corner, the first one belongs to the former end point. Corners whose
+        // blend would start before current_time are not blended, so already executed motion never changes.
+        void appendPath(Path&& path, std::vector<SectionConstraint>&& section_constraints,
+                        std::vector<SegmentConstraint>&& segment_constraints, double current_time);
+
+        // Sliding window mode: pushed waypoints are planned once they are needed within the planning horizon.
+        // The section constraint limits the section ending in the pushed waypoint, the segment constraint the
+        // corner at it.
+        void pushWaypoint(Point&& point, const SectionConstraint& section_constraint,
+                          const SegmentConstraint& segment_constraint);
+        void advanceWindow(double current_time, double planning_horizon);
+        size_t getNumPendingWaypoints() const { return pending_waypoints_.size(); }
+
+        // Continues the path with the whole path of other, which is empty afterwards. Only the blend at the
+        // junction is calculated, the sections and segments of other are moved over and shifted in time by one
+        // shared offset, so the cost does not depend on the length of either path. Both paths need the same memory
+        // resource and no pending waypoints, other has to start at the last waypoint of this path and must not
+        // have retired any of its motion. Remaining lazy blends of both paths are calculated first.
+        void splice(PathManager& other, const SegmentConstraint& junction_constraint);
+
+        // Drops the whole path including pending waypoints, afterwards the memory resource can be released
+        void clear();
+
+        // Drops all segments that ended before time together with the sections and waypoints only they used
+        void retireBefore(double time);
 
         int getNumSections() { return sections_.size(); }
         int getNumSegments() { return segments_.size(); }
-        const std::list<std::shared_ptr<Segment>>& getSegments() const { return segments_; }
-        const std::list<Section>& getSections() const { return sections_; }
+        const std::pmr::list<std::shared_ptr<Segment>>& getSegments() const { return segments_; }
+        const std::pmr::list<Section>& getSections() const { return sections_; }
+
+        // Exact bounds of the positions of every segment with a duration, see SegmentBoundsTree. Covers the
+        // segments blended so far, the reference stays valid until the segments change.
+        const SegmentBoundsTree& getSegmentBounds();
 
         const Section& getSectionAtTime(double time);
         const Segment& getSegmentAtTime(double time);
 
-        const Path& getPath() { return path_; }
+        const std::pmr::list<Point>& getWaypoints() const { return waypoints_; }
+        double getEndTime() const { return segments_.empty() ? 0.0 : segments_.back()->getEndTime(); }
 
         std::ostream& operator<<(std::ostream& out);
     };
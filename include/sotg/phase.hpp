@@ -1,9 +1,7 @@
 #pragma once
 
 #include <cmath>
-#include <vector>
-
-#include "sotg/phase.hpp"
+#include <cstddef>
 
 namespace SOTG {
 namespace detail {
@@ -30,9 +28,30 @@ namespace detail {
         double distance_p_start = 0.0;
     };
 
+    // Components of a phase, one per DoF. They are stored by the section of the phase, copies of the section bind
+    // their phases to their own storage.
+    class PhaseComponents {
+    private:
+        PhaseDoF* data_ = nullptr;
+        size_t size_ = 0;
+
+    public:
+        PhaseComponents() = default;
+        PhaseComponents(PhaseDoF* data, size_t size)
+            : data_(data)
+            , size_(size)
+        {
+        }
+
+        PhaseDoF& operator[](size_t index) const { return data_[index]; }
+        size_t size() const { return size_; }
+        PhaseDoF* begin() const { return data_; }
+        PhaseDoF* end() const { return data_ + size_; }
+    };
+
     // A specific kinematic state that applies to a specific part of a section
     struct Phase {
-        std::vector<PhaseDoF> components;
+        PhaseComponents components;
 
         double duration = 0.0;
         double length = 0.0;
@@ -40,7 +59,7 @@ namespace detail {
         double t_start = 0.0;
         double distance_p_start = 0.0;
 
-        PhaseType type;
+        PhaseType type = ConstantAcceleration;
     };
 }  // namespace detail
 }  // namespace SOTG
\ No newline at end of file
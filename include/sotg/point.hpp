@@ -4,6 +4,7 @@
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -14,22 +15,58 @@
 namespace SOTG {
 
 // Wraps std::vector and allows vector arithmetic, stores information about the
-// unit of a particular value
+// unit of a particular value. The values are allocated from a std::pmr::memory_resource, the default resource
+// unless an allocator is passed. Copies and results of arithmetic use the default resource.
 class Point {
+public:
+    using allocator_type = std::pmr::polymorphic_allocator<double>;
+    using iterator = std::pmr::vector<double>::iterator;
+
 private:
-    std::vector<double> values_;
+    std::pmr::vector<double> values_;
     int orientation_index_ = -1;
     int id_ = -1;
 
 public:
     Point();
+    explicit Point(const allocator_type& alloc);
+    Point(const Point& other, const allocator_type& alloc);
+    Point(Point&& other, const allocator_type& alloc);
+    Point(const Point& other) = default;
+    Point(Point&& other) = default;
+    Point& operator=(const Point& other) = default;
+    Point& operator=(Point&& other) = default;
     explicit Point(std::vector<Eigen::VectorXd> vec_list);
+    // Copies num_values contiguous values with a single allocation
+    Point(const double* values, size_t num_values, int orientation_index = -1);
 
     void addValue(double value) { values_.push_back(value); };
     void setOrientationIndex(int new_index) { orientation_index_ = new_index; };
     void zeros(size_t num_components);
     int getOrientationIndex() const { return orientation_index_; }
 
+    // Eigen views of the values. Expressions of views are evaluated in one pass without temporaries, with a Size
+    // known at compile time their loops are unrolled.
+    template <int Size = Eigen::Dynamic>
+    Eigen::Map<Eigen::Matrix<double, Size, 1>> asVector()
+    {
+        return Eigen::Map<Eigen::Matrix<double, Size, 1>>(values_.data(),
+                                                          static_cast<Eigen::Index>(values_.size()));
+    }
+    template <int Size = Eigen::Dynamic>
+    Eigen::Map<const Eigen::Matrix<double, Size, 1>> asVector() const
+    {
+        return Eigen::Map<const Eigen::Matrix<double, Size, 1>>(values_.data(),
+                                                                static_cast<Eigen::Index>(values_.size()));
+    }
+    // Evaluates an expression of views into the values, keeps the orientation index and reuses the capacity
+    template <typename Derived>
+    void setValues(const Eigen::MatrixBase<Derived>& values)
+    {
+        values_.resize(static_cast<size_t>(values.size()));
+        asVector() = values;
+    }
+
     size_t size() const { return values_.size(); };
     double getValue(int index) const { return values_[index]; };
     Point operator+(const Point& p2) const;
@@ -46,8 +83,8 @@ public:
     Point getLocation();
     Point getOrientation();
 
-    std::vector<double>::iterator begin() { return values_.begin(); }
-    std::vector<double>::iterator end() { return values_.end(); }
+    iterator begin() { return values_.begin(); }
+    iterator end() { return values_.end(); }
 
     friend std::ostream& operator<<(std::ostream& out, const Point& point)
     {
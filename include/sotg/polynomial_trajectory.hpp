@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace SOTG {
+
+// Planned trajectory exported as pieces of constant acceleration per DoF, see TrajectoryGenerator::exportPolynomial.
+// Planning stays in double, only the coefficients are stored as Scalar. With float, dense sampling reads half the
+// memory and needs no double arithmetic except for the piece lookup, e.g. on embedded drive controllers. The start
+// times of the pieces stay in double, so long trajectories keep their time resolution.
+template <typename Scalar>
+class PolynomialTrajectory {
+private:
+    size_t num_dof_ = 0;
+    std::vector<double> start_times_;
+    // Position, velocity and acceleration of all DoF at the start of each piece, one piece after the other
+    std::vector<Scalar> coefficients_;
+    double end_time_ = 0.0;
+
+    // Largest differences to the double evaluation found by the export
+    double max_position_error_ = 0.0;
+    double max_velocity_error_ = 0.0;
+
+    size_t findPiece(double time) const;
+
+public:
+    PolynomialTrajectory() = default;
+    explicit PolynomialTrajectory(size_t num_dof);
+
+    // Appends a piece starting at start_time, which ends where the next one starts. The values are rounded to
+    // Scalar and have num_dof entries each.
+    void addPiece(double start_time, const double* pos, const double* vel, const double* acc);
+    void setEndTime(double end_time);
+    void updateErrorBounds(double position_error, double velocity_error);
+
+    size_t getNumDoF() const { return num_dof_; }
+    size_t getNumPieces() const { return start_times_.size(); }
+    double getStartTime() const { return start_times_.empty() ? 0.0 : start_times_.front(); }
+    double getEndTime() const { return end_time_; }
+    // Largest difference of any DoF to the double evaluation of the planned trajectory
+    double getMaxPositionError() const { return max_position_error_; }
+    double getMaxVelocityError() const { return max_velocity_error_; }
+
+    // pos and vel must hold getNumDoF values. Does not allocate, the first and last state are held before the
+    // start and after the end.
+    void calcPositionAndVelocity(double time, Scalar* pos, Scalar* vel) const;
+};
+
+// Explicit instantiations in polynomial_trajectory.cpp, float for embedded targets and double as reference
+extern template class PolynomialTrajectory<float>;
+extern template class PolynomialTrajectory<double>;
+
+}  // namespace SOTG
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "sotg/logger.hpp"
+
+namespace SOTG {
+
+// Logger that never blocks the thread that logs. Records and messages are copied into a lock free single producer
+// single consumer ring buffer of fixed size, a background thread formats them and passes them to the sink. Entries
+// that find the buffer full are dropped and counted instead of waiting for the sink. Only one thread may log at a
+// time, e.g. the thread that plans and evaluates one trajectory generator.
+class RingBufferLogger : public Logger {
+public:
+    // Messages of log are truncated to this many characters
+    static constexpr size_t MAX_MESSAGE_LENGTH = 95;
+
+private:
+    struct Entry {
+        LogRecord record;
+        // Messages of log are stored as text, records are formatted by the drain thread
+        bool is_message;
+        std::array<char, MAX_MESSAGE_LENGTH + 1> message;
+    };
+
+    const Logger& sink_;
+    std::chrono::milliseconds drain_period_;
+
+    std::unique_ptr<Entry[]> entries_;
+    size_t capacity_;
+
+    // Entries are written at head_ by the logging thread and read at tail_ by the drain thread. Both only grow,
+    // they are kept on separate cache lines so the threads do not slow each other down.
+    alignas(64) mutable std::atomic<size_t> head_{ 0 };
+    alignas(64) std::atomic<size_t> tail_{ 0 };
+    mutable std::atomic<size_t> num_dropped_{ 0 };
+
+    // Wakes the drain thread for flush and destruction, the logging thread never locks it
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool stop_ = false;
+    bool flush_requested_ = false;
+    std::thread drain_thread_;
+
+    // Returns the free entry at the head or nullptr if the buffer is full
+    Entry* reserveEntry() const;
+    void drain();
+    void run();
+
+public:
+    // The capacity is rounded up to a power of two. The sink is called from the drain thread only, it has to
+    // outlive the logger.
+    explicit RingBufferLogger(const Logger& sink, size_t capacity = 1024,
+                              std::chrono::milliseconds drain_period = std::chrono::milliseconds(10));
+    // Passes the remaining entries to the sink before it returns
+    ~RingBufferLogger() override;
+
+    RingBufferLogger(const RingBufferLogger&) = delete;
+    RingBufferLogger& operator=(const RingBufferLogger&) = delete;
+
+    // Entries of types the sink does not enable are not stored
+    void log(const std::string& message, MsgType type = INFO) const override;
+    bool isEnabled(MsgType type) const override { return sink_.isEnabled(type); }
+    void logRecord(const LogRecord& record) const override;
+
+    // Waits until everything logged so far has been passed to the sink, never call it from the logging thread
+    void flush();
+
+    size_t getCapacity() const { return capacity_; }
+    // Entries dropped because the buffer was full or the sink threw
+    size_t getNumDroppedEntries() const { return num_dropped_.load(std::memory_order_relaxed); }
+};
+
+}  // namespace SOTG
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
 #include <vector>
 
 #include "sotg/phase.hpp"
@@ -10,9 +13,32 @@
 namespace SOTG {
 namespace detail {
 
+    // Offsets of a timeline that was spliced into another one, shared by all its sections and segments so that
+    // splicing does not touch them. Offsets add up along the parents, the root timeline of a path has none.
+    struct TimelineOffset {
+        double time = 0.0;
+        std::ptrdiff_t section_id = 0;
+        int waypoint_id = 0;
+        const TimelineOffset* parent = nullptr;
+
+        double getTime() const { return parent == nullptr ? time : time + parent->getTime(); }
+        std::ptrdiff_t getSectionID() const
+        {
+            return parent == nullptr ? section_id : section_id + parent->getSectionID();
+        }
+        int getWaypointID() const
+        {
+            return parent == nullptr ? waypoint_id : waypoint_id + parent->getWaypointID();
+        }
+    };
+
     // Connects to waypoints of a path and is limited by an instance of SectionConstraint
     // Stores kinematic states for position and velocity calculations along this sectionin inside of phases
+    // All members are allocated from the memory resource of the allocator passed on construction
     class Section {
+    public:
+        using allocator_type = std::pmr::polymorphic_allocator<Phase>;
+
     private:
         Point& start_point_;
         Point& end_point_;
@@ -21,12 +47,15 @@ namespace detail {
         double length_;
         SectionConstraint constraint_;
 
-        std::vector<Phase> phases_;
+        // Components of all three phases in one allocation, the phases view into it
+        std::pmr::vector<PhaseDoF> phase_components_;
+        std::array<Phase, 3> phases_;
 
-        int index_slowest_dof_ = -1;
+        // DoF with the largest difference, it carries the synchronized profile of all DoF
+        int index_longest_dof_ = -1;
 
-        std::vector<double> adapted_acceleration_;
-        std::vector<double> adapted_velocity_;
+        std::pmr::vector<double> adapted_acceleration_;
+        std::pmr::vector<double> adapted_velocity_;
 
         double duration_ = 0.0;
         double start_time_ = 0.0;
@@ -36,6 +65,11 @@ namespace detail {
         // time_shift is the duration of the preceeding blend segment, without blending it is always zero
         double time_shift_ = 0.0;
 
+        // Start time and id are stored relative to the timeline, nullptr is the same as the root timeline
+        const TimelineOffset* timeline_ = nullptr;
+
+        void bindPhaseComponents();
+
     public:
         const Point& getStartPoint() const { return start_point_; }
         const Point& getEndPoint() const { return end_point_; }
@@ -44,6 +78,8 @@ namespace detail {
         double getAccMaxAngular() const { return constraint_.getAccelerationMagnitudeAngular(); }
         double getVelMaxLinear() const { return constraint_.getVelocityMagnitudeLinear(); }
         double getVelMaxAngular() const { return constraint_.getVelocityMagnitudeAngular(); }
+        const std::vector<double>& getAccMaxPerDoF() const { return constraint_.getAccelerationPerDoF(); }
+        const std::vector<double>& getVelMaxPerDoF() const { return constraint_.getVelocityPerDoF(); }
 
         double getLength() const { return length_; }
         const Point& getDirection() const { return dir_; }
@@ -52,43 +88,80 @@ namespace detail {
         void setDirection(const Point& dir) { dir_ = dir; }
         void setDifference(const Point& diff) { diff_ = diff; }
 
-        Section(Point& p_start_ref, Point& p_end_ref, SectionConstraint constraint_copy, size_t section_id);
+        Section(Point& p_start_ref, Point& p_end_ref, SectionConstraint constraint_copy, size_t section_id,
+                const allocator_type& alloc = {});
+        Section(const Section& other, const allocator_type& alloc);
+        Section(Section&& other, const allocator_type& alloc);
+        // A copy uses the default memory resource, like the copy of its members would. Moving keeps the storage of
+        // the phase components, so their views stay valid.
+        Section(const Section& other);
+        Section(Section&& other) = default;
 
-        void setIndexSlowestDoF(int index) { index_slowest_dof_ = index; }
+        void setIndexLongestDoF(int index) { index_longest_dof_ = index; }
 
         void setDuration(double time) { duration_ = time; }
         double getDuration() const { return duration_; }
 
         const Phase& getPhaseByDistance(double distance) const;
 
-        const std::vector<double>& getAdaptedAcceleration() const { return adapted_acceleration_; }
-        const std::vector<double>& getAdaptedVelocity() const { return adapted_velocity_; }
-        void setAdaptedAcceleration(const std::vector<double>& new_adapted_acceleration)
+        const std::pmr::vector<double>& getAdaptedAcceleration() const { return adapted_acceleration_; }
+        const std::pmr::vector<double>& getAdaptedVelocity() const { return adapted_velocity_; }
+        template <typename Iterator>
+        void setAdaptedAcceleration(Iterator first, Iterator last)
         {
-            adapted_acceleration_ = new_adapted_acceleration;
+            adapted_acceleration_.assign(first, last);
         }
-        void setAdaptedVelocity(const std::vector<double>& new_adapted_velocity)
+        template <typename Iterator>
+        void setAdaptedVelocity(Iterator first, Iterator last)
         {
-            adapted_velocity_ = new_adapted_velocity;
+            adapted_velocity_.assign(first, last);
         }
 
         const Phase& getPhaseByTime(double time) const;
-        void setPhases(const std::vector<Phase>& new_phases) { phases_ = new_phases; }
-        const std::vector<Phase>& getPhases() const { return phases_; }
+        // Resets the phases to zero with num_dof components each, they are filled in place
+        std::array<Phase, 3>& resetPhases(size_t num_dof);
+        const std::array<Phase, 3>& getPhases() const { return phases_; }
+        allocator_type getAllocator() const { return phase_components_.get_allocator(); }
 
-        double getStartTime() const { return start_time_; }
-        double getEndTime() const { return start_time_ + duration_; }
-        void setStartTime(double new_start_time) { start_time_ = new_start_time; }
+        double getStartTime() const
+        {
+            return timeline_ == nullptr ? start_time_ : start_time_ + timeline_->getTime();
+        }
+        double getEndTime() const { return getStartTime() + duration_; }
+        void setStartTime(double new_start_time)
+        {
+            start_time_ = timeline_ == nullptr ? new_start_time : new_start_time - timeline_->getTime();
+        }
 
-        int getIndexSlowestDoF() const { return index_slowest_dof_; }
+        int getIndexLongestDoF() const { return index_longest_dof_; }
 
         const Phase& getPhaseByType(PhaseType type) const;
 
         void setTimeShift(double shift) { time_shift_ = shift; }
         double getTimeShift() const { return time_shift_; }
 
-        void setID(size_t new_id) { id_ = new_id; }
-        size_t getID() { return id_; }
+        void setID(size_t new_id)
+        {
+            id_ = timeline_ == nullptr ? new_id : new_id - static_cast<size_t>(timeline_->getSectionID());
+        }
+        size_t getID() const
+        {
+            return timeline_ == nullptr ? id_ : id_ + static_cast<size_t>(timeline_->getSectionID());
+        }
+
+        // Ids of the waypoints in the whole path, the ids stored in the waypoints are relative to the timeline
+        int getStartWaypointID() const
+        {
+            return timeline_ == nullptr ? start_point_.getID() : start_point_.getID() + timeline_->getWaypointID();
+        }
+        int getEndWaypointID() const
+        {
+            return timeline_ == nullptr ? end_point_.getID() : end_point_.getID() + timeline_->getWaypointID();
+        }
+
+        // Moves the section into another timeline, its start time and id stay the same
+        void setTimeline(const TimelineOffset* timeline);
+        const TimelineOffset* getTimeline() const { return timeline_; }
     };
 }  // namespace detail
 }  // namespace SOTG
\ No newline at end of file
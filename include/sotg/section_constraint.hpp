@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 namespace SOTG {
 
 // Contains the limiting factors for a section
@@ -11,13 +13,24 @@ private:
     double velocity_magnitude_linear_;
     double velocity_magnitude_angular_;
 
+    // Optional limits of the single DoF, empty if only the magnitudes limit the section
+    std::vector<double> acceleration_per_dof_;
+    std::vector<double> velocity_per_dof_;
+
 public:
     SectionConstraint(double acc_lin, double acc_ang, double vel_lin, double vel_ang);
+    // The per DoF limits hold one value per DoF of the section, e.g. for a slow axis. Both apply together with the
+    // magnitude limits, an empty vector leaves the DoF limited by the magnitudes only.
+    SectionConstraint(double acc_lin, double acc_ang, double vel_lin, double vel_ang,
+                      std::vector<double> acc_per_dof, std::vector<double> vel_per_dof);
 
     double getAccelerationMagnitudeLinear() const { return acceleration_magnitude_linear_; }
     double getAccelerationMagnitudeAngular() const { return acceleration_magnitude_angular_; }
     double getVelocityMagnitudeLinear() const { return velocity_magnitude_linear_; }
     double getVelocityMagnitudeAngular() const { return velocity_magnitude_angular_; }
+
+    const std::vector<double>& getAccelerationPerDoF() const { return acceleration_per_dof_; }
+    const std::vector<double>& getVelocityPerDoF() const { return velocity_per_dof_; }
 };
 
-}  // namespace SOTG
\ No newline at end of file
+}  // namespace SOTG
@@ -12,9 +12,11 @@ namespace detail {
     // between the two.
     class Segment {
     protected:
-        Segment(double duration, double t_start)
+        Segment(double duration, double t_start, const Point::allocator_type& alloc)
             : duration_(duration)
             , start_time_(t_start)
+            , start_point_(alloc)
+            , end_point_(alloc)
             , id_(-1)
         {
         }
@@ -27,26 +29,51 @@ namespace detail {
 
         int id_;
 
+        // Start time and id are stored relative to the timeline, nullptr is the same as the root timeline
+        const TimelineOffset* timeline_ = nullptr;
+
     public:
         virtual void calcPosAndVel([[maybe_unused]] double t_section, [[maybe_unused]] double t_segment,
                                    Point& pos, Point& vel, const KinematicSolver& solver) const = 0;
 
         void setDuration(double duration) { duration_ = duration; }
-        void setStartTime(double t_start) { start_time_ = t_start; }
+        void setStartTime(double t_start)
+        {
+            start_time_ = timeline_ == nullptr ? t_start : t_start - timeline_->getTime();
+        }
 
         void setStartPoint(const Point& p) { start_point_ = p; }
         void setEndPoint(const Point& p) { end_point_ = p; }
 
-        void setID(int num) { id_ = num; }
+        void setID(int num)
+        {
+            id_ = timeline_ == nullptr ? num : num - 2 * static_cast<int>(timeline_->getSectionID());
+        }
 
-        double getStartTime() const { return start_time_; }
+        double getStartTime() const
+        {
+            return timeline_ == nullptr ? start_time_ : start_time_ + timeline_->getTime();
+        }
         double getDuration() const { return duration_; }
-        double getEndTime() const { return start_time_ + duration_; }
+        double getEndTime() const { return getStartTime() + duration_; }
 
         const Point& getStartPoint() const { return start_point_; }
         const Point& getEndPoint() const { return end_point_; }
 
-        int getID() const { return id_; }
+        int getID() const
+        {
+            return timeline_ == nullptr ? id_ : id_ + 2 * static_cast<int>(timeline_->getSectionID());
+        }
+
+        // Moves the segment into another timeline, its start time and id stay the same
+        void setTimeline(const TimelineOffset* timeline)
+        {
+            double start_time = getStartTime();
+            int id = getID();
+            timeline_ = timeline;
+            setStartTime(start_time);
+            setID(id);
+        }
 
         virtual Section& getPreBlendSection() const
         {
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "sotg/bounding_box.hpp"
+#include "sotg/box_hierarchy.hpp"
+
+namespace SOTG {
+
+// Exact bounds of the positions of one segment, the values before the orientation index
+struct SegmentBounds {
+    int segment_id;
+    double start_time;
+    double end_time;
+    BoundingBox box;
+};
+
+// Bounds of the linear and blend segments in order of time, see TrajectoryGenerator::getSegmentBounds. A balanced
+// tree over the segments stores the bounds and the time interval of each subtree, so the segments that enter a
+// region are found in logarithmic time per found segment.
+class SegmentBoundsTree {
+private:
+    size_t num_dof_ = 0;
+    std::vector<SegmentBounds> segments_;
+    detail::BoxHierarchy hierarchy_;
+
+public:
+    SegmentBoundsTree() = default;
+    // Takes the bounds in order of time, all of them over num_dof values
+    SegmentBoundsTree(size_t num_dof, std::vector<SegmentBounds>&& segments);
+
+    size_t getNumDoF() const { return num_dof_; }
+    const std::vector<SegmentBounds>& getSegments() const { return segments_; }
+    // Bounds of all segments, empty without segments
+    BoundingBox getBoundingBox() const;
+
+    // Appends the indices into getSegments of the segments whose bounds intersect the region and whose time
+    // interval overlaps [start_time, end_time], in order of time. Returns the number of found segments.
+    size_t findSegmentsInRegion(const BoundingBox& region, std::vector<size_t>& indices,
+                                double start_time = -std::numeric_limits<double>::infinity(),
+                                double end_time = std::numeric_limits<double>::infinity()) const;
+};
+
+}  // namespace SOTG
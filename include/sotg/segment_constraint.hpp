@@ -2,6 +2,23 @@
 
 namespace SOTG {
 
+// What the solver does at a corner whose blend would exceed the acceleration limits
+enum BlendFallback {
+    // The blend is dropped, the motion stops at the corner
+    STOP_AT_CORNER,
+    // The blend distance is extended up to half the pre section, the blend then deviates further from the
+    // corner than requested. Stops at the corner if no distance keeps the limits. With blend optimization the
+    // distance is only extended as far as the blend stays within the deviation tolerance.
+    EXTEND_BLEND_DISTANCE
+};
+
+// Outcome of the acceleration check of a blend, stored with each blend segment
+enum BlendFallbackResult {
+    WITHIN_LIMITS,
+    EXTENDED_BLEND,
+    STOPPED
+};
+
 // Contains limiting factors for segments
 class SegmentConstraint {
 private:
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "sotg/blend_segment.hpp"
+#include "sotg/kinematic_solver.hpp"
+#include "sotg/point.hpp"
+#include "sotg/section.hpp"
+#include "sotg/segment.hpp"
+
+namespace SOTG {
+namespace detail {
+
+    // Part of a segment with constant acceleration per DoF
+    struct ConstantAccelerationPiece {
+        const Segment* segment;
+        double start_time;
+        double end_time;
+    };
+
+    // State of the segment at the absolute time, like TrajectoryGenerator::calcPositionAndVelocity but without the
+    // segment lookup
+    void evaluateSegment(const Segment& segment, double time, const KinematicSolver& solver, Point& pos,
+                         Point& vel);
+
+    // Blends accelerate constantly, linear segments change their acceleration at the ends of their phases.
+    // Segments and pieces without duration are skipped.
+    void appendPieces(const Segment& segment, std::vector<ConstantAccelerationPiece>& pieces);
+    std::vector<ConstantAccelerationPiece>
+    splitIntoPieces(const std::pmr::list<std::shared_ptr<Segment>>& segments);
+
+    // State at the start of the piece and its acceleration, of the first num_dof values
+    void calcPieceCoefficients(const ConstantAccelerationPiece& piece, const KinematicSolver& solver,
+                               size_t num_dof, double* pos, double* vel, double* acc);
+
+    // Number of values before the orientation index of the section, those are interpolated component wise
+    // regardless of the orientation interpolation
+    size_t getNumPositionDoF(const Section& section);
+
+    // Real roots of c3 t^3 + c2 t^2 + c1 t + c0, lower degrees if the leading coefficients vanish
+    int solveCubic(double c3, double c2, double c1, double c0, std::array<double, 3>& roots);
+
+    // Closest approach of pos + vel * t + acc * t^2 / 2 to point for t in [t_begin, t_end], over the first num_dof
+    // values. The squared distance is extremal where its derivative, a cubic, vanishes. Returns the squared
+    // distance and sets time to the t of the approach.
+    double calcClosestApproach(const double* pos, const double* vel, const double* acc, size_t num_dof,
+                               const double* point, double t_begin, double t_end, double& time);
+
+    // Distance of the location of a blend from pre_section to post_section to their corner at its closest
+    // approach, orientations are not considered. The blend is the parabola of
+    // ConstantAccelerationSolver::calcPosAndVelBlendSegment, it is not allocated as a segment.
+    double calcBlendDeviation(const BlendParameters& params, const Section& pre_section,
+                              const Section& post_section);
+
+}  // namespace detail
+}  // namespace SOTG
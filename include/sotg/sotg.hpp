@@ -1,7 +1,18 @@
 #pragma once
 
+#include "sotg/bounding_box.hpp"
+#include "sotg/distance_query.hpp"
+#include "sotg/event_timeline.hpp"
+#include "sotg/instrumentation.hpp"
 #include "sotg/logger.hpp"
+#include "sotg/orientation.hpp"
 #include "sotg/path.hpp"
+#include "sotg/polynomial_trajectory.hpp"
+#include "sotg/ring_buffer_logger.hpp"
 #include "sotg/section_constraint.hpp"
+#include "sotg/segment_bounds.hpp"
 #include "sotg/segment_constraint.hpp"
-#include "sotg/trajectory_generator.hpp"
\ No newline at end of file
+#include "sotg/stop_trajectory.hpp"
+#include "sotg/tracing.hpp"
+#include "sotg/trajectory_generator.hpp"
+#include "sotg/waypoint_reader.hpp"
\ No newline at end of file
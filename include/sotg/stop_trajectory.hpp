@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace SOTG {
+
+// Motion from a state of the planned trajectory to rest along its path, see TrajectoryGenerator::planStop. It
+// consists of up to two pieces of constant acceleration per DoF, the rest of a blend if the stop begins in one and
+// the deceleration along the following section. All values live in fixed size storage, so a stop is planned and
+// evaluated without allocating.
+class StopTrajectory {
+public:
+    static constexpr size_t MAX_DOF = 9;
+    static constexpr size_t MAX_PIECES = 2;
+
+    using Values = std::array<double, MAX_DOF>;
+
+private:
+    struct Piece {
+        double duration = 0.0;
+        Values pos{};
+        Values vel{};
+        Values acc{};
+    };
+
+    std::array<Piece, MAX_PIECES> pieces_{};
+    size_t num_pieces_ = 0;
+    size_t num_dof_ = 0;
+    double start_time_ = 0.0;
+
+public:
+    StopTrajectory() = default;
+    StopTrajectory(size_t num_dof, double start_time);
+
+    // Appends a piece starting in pos and vel, values beyond the number of DoF are ignored
+    void addPiece(double duration, const Values& pos, const Values& vel, const Values& acc);
+
+    size_t getNumDoF() const { return num_dof_; }
+    // Time of the planned trajectory the stop leaves it at
+    double getStartTime() const { return start_time_; }
+    double getDuration() const;
+
+    // t is relative to the start of the stop, the rest position is held after the duration
+    void calcPositionAndVelocity(double t, Values& pos, Values& vel) const;
+};
+
+}  // namespace SOTG
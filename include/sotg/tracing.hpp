@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace SOTG {
+
+// Receives the begin and end of named trace zones if SOTG is built with TRACING defined. Implement it to forward
+// the zones to a profiler, zone names are string literals that live as long as the program.
+class Tracer {
+public:
+    virtual void beginZone(const char* name) = 0;
+    virtual void endZone(const char* name) = 0;
+
+    virtual ~Tracer() = default;
+};
+
+// Writes the zones as Chrome trace event JSON, which can be opened in chrome://tracing or Perfetto
+class ChromeTraceWriter : public Tracer {
+private:
+    std::ofstream file_;
+    std::mutex mutex_;
+    std::chrono::steady_clock::time_point start_;
+    std::map<std::thread::id, size_t> thread_ids_;
+    bool is_first_event_ = true;
+
+    void writeEvent(const char* name, char phase);
+
+public:
+    ChromeTraceWriter(const std::string& file_name);
+    ~ChromeTraceWriter() override;
+
+    void beginZone(const char* name) override;
+    void endZone(const char* name) override;
+    void flush();
+};
+
+namespace detail {
+
+    // Marks its lifetime as a zone of tracer, does nothing without tracer
+    class TraceZone {
+    private:
+        Tracer* tracer_;
+        const char* name_;
+
+    public:
+        TraceZone(Tracer* tracer, const char* name)
+            : tracer_(tracer)
+            , name_(name)
+        {
+            if (tracer_ != nullptr) {
+                tracer_->beginZone(name_);
+            }
+        }
+
+        ~TraceZone()
+        {
+            if (tracer_ != nullptr) {
+                tracer_->endZone(name_);
+            }
+        }
+
+        TraceZone(const TraceZone&) = delete;
+        TraceZone& operator=(const TraceZone&) = delete;
+    };
+
+}  // namespace detail
+}  // namespace SOTG
+
+#ifdef TRACING
+#define SOTG_TRACE_ZONE(tracer, name) ::SOTG::detail::TraceZone sotg_trace_zone_(tracer, name)
+#else
+#define SOTG_TRACE_ZONE(tracer, name)                                                                             \
+    do {                                                                                                          \
+    } while (false)
+#endif
@@ -2,19 +2,40 @@
 #pragma once
 
 #include <memory>
+#include <memory_resource>
 
 #include "sotg/constant_acceleration_solver.hpp"
+#include "sotg/distance_query.hpp"
+#include "sotg/event_timeline.hpp"
+#include "sotg/instrumentation.hpp"
 #include "sotg/kinematic_solver.hpp"
 #include "sotg/logger.hpp"
 #include "sotg/path.hpp"
 #include "sotg/path_manager.hpp"
 #include "sotg/point.hpp"
+#include "sotg/polynomial_trajectory.hpp"
 #include "sotg/section.hpp"
 #include "sotg/section_constraint.hpp"
+#include "sotg/segment_bounds.hpp"
 #include "sotg/segment_constraint.hpp"
+#include "sotg/stop_trajectory.hpp"
+#include "sotg/tracing.hpp"
 
 namespace SOTG {
 
+// Blends of the current path whose requested blend distance exceeded the acceleration limits, see BlendFallback
+struct BlendFallbackReport {
+    size_t num_blends = 0;
+    size_t num_extended = 0;
+    size_t num_stopped = 0;
+
+    // Increase of the pre blend distance over the requested one, summed over and largest of all extended blends
+    double total_distance_increase = 0.0;
+    double max_distance_increase = 0.0;
+
+    size_t getNumDegraded() const { return num_extended + num_stopped; }
+};
+
 // The enty point for interactions with SOTG in the form of new input or position and velocity calculations for a
 // specifc point in time
 class TrajectoryGenerator {
@@ -25,18 +46,144 @@ private:
     std::unique_ptr<detail::PathManager> path_manager_;
     std::shared_ptr<detail::KinematicSolver> kinematic_solver_;
 
+    // Built from the blend segments by getDebugInfo
     std::vector<std::map<std::string, double>> debug_info_vec_;
+    Instrumentation instrumentation_;
+    Tracer* tracer_ = nullptr;
 
 public:
     TrajectoryGenerator();
     TrajectoryGenerator(const Logger& logger);
+    // Uses a solver specialized for NumDoF values per waypoint, e.g. TrajectoryGenerator(FixedDoF<6>()). Every
+    // waypoint must have exactly NumDoF values
+    template <int NumDoF>
+    explicit TrajectoryGenerator(FixedDoF<NumDoF>);
+    template <int NumDoF>
+    TrajectoryGenerator(FixedDoF<NumDoF>, const Logger& logger);
+
+    // Trace zones are only emitted if SOTG is built with TRACING defined. The tracer is not owned and must outlive
+    // the trajectory generator, nullptr disables tracing.
+    void setTracer(Tracer* tracer);
+
+    // Waypoints, sections and segments are allocated from resource instead of the default resource, e.g. a
+    // std::pmr::monotonic_buffer_resource that is released between replanning cycles. Drops the current path.
+    // The resource is not owned and must outlive the trajectory generator or the next call to clearPath.
+    void setMemoryResource(std::pmr::memory_resource* resource);
+    // Drops the current path and all pending waypoints, nothing allocated from the memory resource is used
+    // afterwards
+    void clearPath();
+
+    // With lazy blending resetPath only calculates the sections, blends are calculated in order once the evaluated
+    // time comes within look_ahead_time seconds of them. Motion that was evaluated never changes afterwards.
+    // getDuration and appendPath calculate all remaining blends. Applies from the next resetPath on.
+    void enableLazyBlending(double look_ahead_time);
+    void disableLazyBlending();
+
+    // Replaces the blend distances of the segment constraints by the ones that minimize the duration while every
+    // blend passes its corner within max_deviation, zero blend distances stay exact stops. Every corner is
+    // searched independently with a few blend calculations. Applies from the next resetPath on.
+    void enableBlendOptimization(double max_deviation);
+    void disableBlendOptimization();
+
+    // Must be set before the path is planned, see BlendFallback
+    void setBlendFallback(BlendFallback fallback);
+    // Calculates all remaining blends
+    BlendFallbackReport getBlendFallbackReport();
+
+    // Must be set before the path is planned, see OrientationInterpolation
+    void setOrientationInterpolation(OrientationInterpolation type);
 
     double getDuration();
     int getNumPassedWaypoints(double tick);
+    // Waypoints reached, blends and phase changes of the planned trajectory with their exact times, to be fired
+    // every tick instead of polling getNumPassedWaypoints. Calculates all remaining blends, rebuild it after the
+    // path changed.
+    EventTimeline buildEventTimeline();
     void calcPositionAndVelocity(double time, Point& pos, Point& vel, int& id, bool disable_blending = false);
-    void resetPath(Path path, std::vector<SectionConstraint> section_constraints,
-                   std::vector<SegmentConstraint> segment_constraints);
+    // Stop along the path from the state at time as fast as the adapted limits of the sections allow. A blend
+    // that has begun is finished first. Reads only the segment at time and does not allocate, unless lazy
+    // blending has to calculate blends up to time first. Needs component wise orientation interpolation.
+    StopTrajectory planStop(double time);
+    // The const reference overload copies the input once, the rvalue overload moves it into the path manager
+    // without copying any waypoint
+    void resetPath(const Path& path, const std::vector<SectionConstraint>& section_constraints,
+                   const std::vector<SegmentConstraint>& segment_constraints);
+    void resetPath(Path&& path, std::vector<SectionConstraint>&& section_constraints,
+                   std::vector<SegmentConstraint>&& segment_constraints);
+    // Continues the trajectory with new waypoints while it is being executed, current_time is the time that was
+    // last evaluated. Expects one section and one segment constraint per new waypoint, see PathManager::appendPath
+    void appendPath(Path&& path, std::vector<SectionConstraint>&& section_constraints,
+                    std::vector<SegmentConstraint>&& segment_constraints, double current_time);
+    // Continues the trajectory with the whole trajectory of other, which starts at the last waypoint and is empty
+    // afterwards. Only the blend at the junction is calculated, the motion of other is taken over by shifting its
+    // start time, so joining precomputed motions does not depend on their length. See PathManager::splice
+    void splice(TrajectoryGenerator& other, const SegmentConstraint& junction_constraint);
 
-    std::vector<std::map<std::string, double>>& getDebugInfo() { return debug_info_vec_; };
+    // Sliding window mode for endless paths: waypoints are pushed one by one and only planned once they are
+    // needed within planning_horizon seconds ahead of current_time. Sections and segments that already ended
+    // are dropped, so memory and work per call stay constant. Call advanceSlidingWindow once every tick before
+    // calcPositionAndVelocity.
+    void pushWaypoint(Point point, const SectionConstraint& section_constraint,
+                      const SegmentConstraint& segment_constraint);
+    void advanceSlidingWindow(double current_time, double planning_horizon);
+    size_t getNumPendingWaypoints() const { return path_manager_->getNumPendingWaypoints(); }
+
+    // Runs Path::preprocess on the input before planning, see PreprocessingOptions
+    PreprocessingReport resetPath(Path path, std::vector<SectionConstraint> section_constraints,
+                                  std::vector<SegmentConstraint> segment_constraints,
+                                  const PreprocessingOptions& options);
+
+    // Closest approach queries of the positions, the values before the orientation index, to point sets. Built
+    // from the straight sections and parabolic blends of the planned trajectory, see DistanceQuery. Calculates all
+    // remaining blends, rebuild it after the path changed.
+    DistanceQuery buildDistanceQuery();
+
+    // Exact bounds of the positions of every linear and blend segment, the values before the orientation index.
+    // Answers which segments enter a region without sampling. Calculates all remaining blends, the reference
+    // stays valid until the path changes.
+    const SegmentBoundsTree& getSegmentBounds();
+
+    // Samples the whole trajectory every sample_period seconds, num_dof positions and velocities per sample one
+    // after the other. The outputs are sized once, then the samples are split evenly between num_threads threads,
+    // zero uses one per core. Every thread finds the segment of its first sample and walks the segments from
+    // there without shared state. Calculates all remaining blends, returns the number of samples.
+    size_t sampleTrajectory(double sample_period, std::vector<double>& positions, std::vector<double>& velocities,
+                            size_t num_threads = 0);
+
+    // Exports the planned trajectory as pieces of constant acceleration with coefficients of type Scalar, float or
+    // double. Every piece is compared to the double evaluation at its start, middle and end, the largest
+    // differences are kept as error bounds of the export. Calculates all remaining blends and needs component
+    // wise orientation interpolation.
+    template <typename Scalar>
+    PolynomialTrajectory<Scalar> exportPolynomial();
+
+    // One entry per blend segment of the current path in order of the segments, collected from the segments on
+    // every call. Blends that were retired or are not calculated yet by lazy blending have no entry. Entries of
+    // earlier paths are dropped with their segments, before they were kept across resetPath.
+    std::vector<std::map<std::string, double>>& getDebugInfo();
+    // Counters and latency histograms, only filled if SOTG is built with INSTRUMENTATION defined
+    Instrumentation& getInstrumentation() { return instrumentation_; }
 };
-}  // namespace SOTG
\ No newline at end of file
+
+template <int NumDoF>
+TrajectoryGenerator::TrajectoryGenerator(FixedDoF<NumDoF>)
+    : default_logger_(new Logger())
+    , logger_(*default_logger_)
+    , kinematic_solver_(new detail::ConstantAccelerationSolver<NumDoF>(logger_))
+{
+    static_assert(NumDoF > 0 && NumDoF <= detail::MAX_FIXED_DOF, "No fixed DoF solver for this number of DoF");
+    path_manager_ = std::unique_ptr<detail::PathManager>(
+        new detail::PathManager(kinematic_solver_, instrumentation_));
+}
+
+template <int NumDoF>
+TrajectoryGenerator::TrajectoryGenerator(FixedDoF<NumDoF>, const Logger& logger)
+    : logger_(logger)
+    , kinematic_solver_(new detail::ConstantAccelerationSolver<NumDoF>(logger_))
+{
+    static_assert(NumDoF > 0 && NumDoF <= detail::MAX_FIXED_DOF, "No fixed DoF solver for this number of DoF");
+    path_manager_ = std::unique_ptr<detail::PathManager>(
+        new detail::PathManager(kinematic_solver_, instrumentation_));
+}
+
+}  // namespace SOTG
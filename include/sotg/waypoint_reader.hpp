@@ -0,0 +1,55 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "sotg/path.hpp"
+#include "sotg/section_constraint.hpp"
+#include "sotg/segment_constraint.hpp"
+
+namespace SOTG {
+
+// Reads waypoints and their constraints chunk by chunk from a CSV or raw binary file, so that huge programs can
+// be fed into TrajectoryGenerator::appendPath without ever being loaded completely.
+// Every row holds the values of one waypoint followed by five constraint columns:
+//   acc_lin, acc_ang, vel_lin, vel_ang   limits of the section ending in this waypoint, ignored in the first row
+//   blend_dist                           blend distance of the corner at this waypoint, ignored in the first and
+//                                        last row
+// CSV rows are separated by newlines and values by commas, empty lines and lines starting with '#' are skipped.
+// Binary files contain the same rows as native doubles without any header.
+class WaypointReader {
+public:
+    enum Format { CSV, BINARY };
+
+    WaypointReader(const std::string& file_name, Format format, size_t num_values, int orientation_index = -1);
+
+    // Reads up to max_waypoints rows, the first chunk contains at least two. The constraint vectors are sized as
+    // TrajectoryGenerator::appendPath expects them, the first chunk as resetPath does. Returns false once the
+    // file is exhausted.
+    bool readChunk(size_t max_waypoints, Path& path, std::vector<SectionConstraint>& section_constraints,
+                   std::vector<SegmentConstraint>& segment_constraints);
+
+    size_t getNumReadWaypoints() const { return num_read_rows_; }
+
+private:
+    std::ifstream file_;
+    std::string file_name_;
+    Format format_;
+    size_t num_values_;
+    int orientation_index_;
+
+    std::vector<double> row_;
+    std::vector<double> values_;
+    std::string line_;
+    size_t line_number_ = 0;
+
+    size_t num_read_rows_ = 0;
+    double pending_blend_distance_ = 0.0;
+
+    bool readRow();
+    bool readCSVRow();
+    bool readBinaryRow();
+};
+
+}  // namespace SOTG
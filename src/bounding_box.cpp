@@ -0,0 +1,70 @@
+#include "sotg/bounding_box.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+using namespace SOTG;
+
+BoundingBox::BoundingBox(size_t num_dof)
+    : min(num_dof, std::numeric_limits<double>::infinity())
+    , max(num_dof, -std::numeric_limits<double>::infinity())
+{
+}
+
+bool BoundingBox::isEmpty() const
+{
+    return min.empty() || min[0] > max[0];
+}
+
+void BoundingBox::extend(const BoundingBox& other)
+{
+    if (other.getNumDoF() != getNumDoF()) {
+        throw std::runtime_error("BoundingBox: Can not extend a box over " + std::to_string(getNumDoF())
+                                 + " DoF by one over " + std::to_string(other.getNumDoF()));
+    }
+    for (size_t i = 0; i < min.size(); ++i) {
+        min[i] = std::min(min[i], other.min[i]);
+        max[i] = std::max(max[i], other.max[i]);
+    }
+}
+
+void BoundingBox::extendByQuadratic(const double* pos, const double* vel, const double* acc, double duration)
+{
+    for (size_t i = 0; i < min.size(); ++i) {
+        double end = pos[i] + (vel[i] + 0.5 * acc[i] * duration) * duration;
+        min[i] = std::min({ min[i], pos[i], end });
+        max[i] = std::max({ max[i], pos[i], end });
+
+        // The velocity of the DoF changes its sign within the duration
+        if (acc[i] != 0.0) {
+            double t_extremum = -vel[i] / acc[i];
+            if (t_extremum > 0.0 && t_extremum < duration) {
+                double extremum = pos[i] + 0.5 * vel[i] * t_extremum;
+                min[i] = std::min(min[i], extremum);
+                max[i] = std::max(max[i], extremum);
+            }
+        }
+    }
+}
+
+double BoundingBox::calcSquaredDistance(const double* point) const
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < min.size(); ++i) {
+        double difference = std::max({ min[i] - point[i], point[i] - max[i], 0.0 });
+        sum += difference * difference;
+    }
+    return sum;
+}
+
+bool BoundingBox::intersects(const BoundingBox& other) const
+{
+    for (size_t i = 0; i < min.size() && i < other.min.size(); ++i) {
+        if (min[i] > other.max[i] || other.min[i] > max[i]) {
+            return false;
+        }
+    }
+    return !isEmpty() && !other.isEmpty();
+}
@@ -3,84 +3,166 @@
 using namespace SOTG;
 using namespace detail;
 
-int findIndexOfMax(const std::vector<double>& values);
-double calcVecNorm(const std::vector<double>& vec);
-double calcPhaseLength(const Phase& phase);
+namespace {
+// Bisection steps of the blend distance fallback, the feasible distance is found within 2^-8 of the search range
+constexpr int NUM_BLEND_FALLBACK_STEPS = 8;
+}  // namespace
 
-double calcPhaseLength(const Phase& phase)
+double calcVecNorm(const std::pmr::vector<double>& vec);
+
+template <int NumDoF>
+size_t ConstantAccelerationSolver<NumDoF>::getNumDoF(const Section& section)
 {
-    double sum = 0.0;
-    for (auto& component : phase.components) {
-        sum += std::pow(component.length, 2);
+    size_t num_dof = section.getDifference().size();
+    if constexpr (NumDoF != DYNAMIC_DOF) {
+        if (num_dof != NumDoF) {
+            throw std::runtime_error("Solver is specialized for " + std::to_string(NumDoF)
+                                     + " DoF but section has " + std::to_string(num_dof));
+        }
     }
-    return std::sqrt(sum);
+    return num_dof;
 }
 
-void ConstantAccelerationSolver::calcAccAndVelPerDoF(const Section& section, std::vector<double>& a_max_vec,
-                                                     std::vector<double>& v_max_vec)
+template <int NumDoF>
+typename ConstantAccelerationSolver<NumDoF>::DoFVector
+ConstantAccelerationSolver<NumDoF>::makeDoFVector([[maybe_unused]] size_t num_dof)
 {
-    Point p_start = section.getStartPoint();
-    Point p_end = section.getEndPoint();
+    if constexpr (NumDoF == DYNAMIC_DOF) {
+        return DoFVector(num_dof, 0.0);
+    } else {
+        return DoFVector{};
+    }
+}
+
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcAccAndVelPerDoF(const Section& section, DoFVector& a_max_vec,
+                                                             DoFVector& v_max_vec)
+{
+    const Point& p_start = section.getStartPoint();
+    const Point& diff = section.getDifference();
+    const size_t num_dof = getNumDoF(section);
 
     double a_max_lin = section.getAccMaxLinear();
     double a_max_ang = section.getAccMaxAngular();
     double v_max_lin = section.getVelMaxLinear();
     double v_max_ang = section.getVelMaxAngular();
 
-    Point dir_lin;
-    Point diff_lin;
-
-    Point dir_ang;
-    Point diff_ang;
+    // Without orientation index all values are linear
+    size_t o_index = num_dof;
     if (p_start.getOrientationIndex() != -1) {
-        for (int i = 0; i < p_start.getOrientationIndex(); i++) {
-            diff_lin.addValue(p_end[i] - p_start[i]);
-        }
-        double diff_lin_mag = diff_lin.norm();
+        o_index = p_start.getOrientationIndex();
+    }
 
-        if (utility::nearlyZero(diff_lin_mag)) {
-            dir_lin.zeros(diff_lin.size());
-        } else {
-            dir_lin = diff_lin / diff_lin_mag;
-        }
+    double diff_lin_mag = 0.0;
+    for (size_t i = 0; i < o_index; i++) {
+        diff_lin_mag += std::pow(diff[i], 2);
+    }
+    diff_lin_mag = std::sqrt(diff_lin_mag);
 
-        for (size_t i = p_start.getOrientationIndex(); i < p_start.size(); i++) {
-            diff_ang.addValue(p_end[i] - p_start[i]);
-        }
-        double diff_ang_mag = diff_ang.norm();
+    double diff_ang_mag = 0.0;
+    for (size_t i = o_index; i < num_dof; i++) {
+        diff_ang_mag += std::pow(diff[i], 2);
+    }
+    diff_ang_mag = std::sqrt(diff_ang_mag);
 
-        if (utility::nearlyZero(diff_ang_mag)) {
-            dir_ang.zeros(diff_ang.size());
-        } else {
-            dir_ang = diff_ang / diff_ang_mag;
+    // The limits are projected onto the direction of the section
+    for (size_t i = 0; i < num_dof; i++) {
+        bool is_linear = i < o_index;
+        double diff_mag = is_linear ? diff_lin_mag : diff_ang_mag;
+        double dir = utility::nearlyZero(diff_mag) ? 0.0 : diff[i] / diff_mag;
+
+        a_max_vec[i] = std::abs((is_linear ? a_max_lin : a_max_ang) * dir);
+        v_max_vec[i] = std::abs((is_linear ? v_max_lin : v_max_ang) * dir);
+    }
+
+    // Per DoF limits scale all projections down together, so that the DoF stay synchronized on a straight line
+    const std::vector<double>& a_max_per_dof = section.getAccMaxPerDoF();
+    const std::vector<double>& v_max_per_dof = section.getVelMaxPerDoF();
+    if ((!a_max_per_dof.empty() && a_max_per_dof.size() != num_dof)
+        || (!v_max_per_dof.empty() && v_max_per_dof.size() != num_dof)) {
+        throw std::runtime_error("In section Nr." + std::to_string(section.getID()) + " per DoF limits for "
+                                 + std::to_string(std::max(a_max_per_dof.size(), v_max_per_dof.size()))
+                                 + " DoF where given, but the section has " + std::to_string(num_dof));
+    }
+    double acc_scaling_factor = 1.0;
+    for (size_t i = 0; i < a_max_per_dof.size(); i++) {
+        if (a_max_vec[i] > a_max_per_dof[i]) {
+            acc_scaling_factor = std::min(acc_scaling_factor, a_max_per_dof[i] / a_max_vec[i]);
         }
-    } else {
-        for (size_t i = 0; i < p_start.size(); i++) {
-            diff_lin.addValue(p_end[i] - p_start[i]);
+    }
+    double vel_scaling_factor = 1.0;
+    for (size_t i = 0; i < v_max_per_dof.size(); i++) {
+        if (v_max_vec[i] > v_max_per_dof[i]) {
+            vel_scaling_factor = std::min(vel_scaling_factor, v_max_per_dof[i] / v_max_vec[i]);
         }
-        double diff_lin_mag = diff_lin.norm();
+    }
+    for (size_t i = 0; i < num_dof; i++) {
+        a_max_vec[i] *= acc_scaling_factor;
+        v_max_vec[i] *= vel_scaling_factor;
+    }
+}
 
-        if (utility::nearlyZero(diff_lin_mag)) {
-            dir_lin.zeros(diff_lin.size());
-        } else {
-            dir_lin = diff_lin / diff_lin_mag;
-        }
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::setRotationVectorDifference(Section& section)
+{
+    const Point& p_start = section.getStartPoint();
+    const Point& p_end = section.getEndPoint();
+    size_t o_index = p_start.getOrientationIndex();
+
+    Eigen::Vector3d rotation_vector = calcRotationVector(calcQuaternion(p_start), calcQuaternion(p_end));
+
+    Point diff;
+    for (size_t i = 0; i < o_index; ++i) {
+        diff.addValue(p_end[i] - p_start[i]);
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        diff.addValue(rotation_vector[i]);
+    }
+    diff.setOrientationIndex(o_index);
+
+    double length = diff.norm();
+    section.setDifference(diff);
+    section.setLength(length);
+    if (utility::nearlyZero(length)) {
+        Point dir;
+        dir.zeros(diff.size());
+        dir.setOrientationIndex(o_index);
+        section.setDirection(dir);
+    } else {
+        section.setDirection(diff / length);
     }
+}
 
-    for (auto& dir : dir_lin) {
-        a_max_vec.push_back(std::abs(a_max_lin * dir));
-        v_max_vec.push_back(std::abs(v_max_lin * dir));
+template <int NumDoF>
+Eigen::Vector3d ConstantAccelerationSolver<NumDoF>::calcEulerReference(const Section& section,
+                                                                       const Point& pos_path_space) const
+{
+    const Point& p_start = section.getStartPoint();
+    const Point& p_end = section.getEndPoint();
+    const Point& diff = section.getDifference();
+
+    double progress = 0.0;
+    double length_squared = std::pow(section.getLength(), 2);
+    if (!utility::nearlyZero(length_squared)) {
+        for (size_t i = 0; i < diff.size(); ++i) {
+            progress += (pos_path_space[i] - p_start[i]) * diff[i];
+        }
+        progress /= length_squared;
     }
-    for (auto& dir : dir_ang) {
-        a_max_vec.push_back(std::abs(a_max_ang * dir));
-        v_max_vec.push_back(std::abs(v_max_ang * dir));
+
+    size_t o_index = p_start.getOrientationIndex();
+    Eigen::Vector3d angles;
+    for (size_t i = 0; i < 3; ++i) {
+        angles[i] = p_start[o_index + i] + (p_end[o_index + i] - p_start[o_index + i]) * progress;
     }
+    return angles;
 }
 
-void ConstantAccelerationSolver::calcPhaseTimeAndDistance(double& a_max, double& v_max, double L_total,
-                                                          PhaseDoF& acc_phase_single_dof,
-                                                          PhaseDoF& coast_phase_single_dof,
-                                                          PhaseDoF& dec_phase_single_dof)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPhaseTimeAndDistance(double& a_max, double& v_max, double L_total,
+                                                                  PhaseDoF& acc_phase_single_dof,
+                                                                  PhaseDoF& coast_phase_single_dof,
+                                                                  PhaseDoF& dec_phase_single_dof)
 {
     double T_acc;
     double T_coast;
@@ -123,195 +205,153 @@ void ConstantAccelerationSolver::calcPhaseTimeAndDistance(double& a_max, double&
     dec_phase_single_dof.distance_p_start = L_acc + L_coast;
 }
 
-int findIndexOfMax(const std::vector<double>& values)
+template <int NumDoF>
+double ConstantAccelerationSolver<NumDoF>::calcTotalTimeSingleDoF(double a_max, double& v_max, double total_length)
 {
-    int index_max = 0;
-    double max_value = values[0];
-    for (size_t i = 1; i < values.size(); i++) {
-        if (values[i] > max_value) {
-            max_value = values[i];
-            index_max = i;
+    // Bang coast bang profile, a negative coast length means v_max can not be reached within total_length
+    for (int profile = 0;; ++profile) {
+        double T_acc = utility::nearlyZero(a_max) ? 0.0 : v_max / a_max;
+        double L_acc = utility::nearlyZero(a_max) ? 0.0 : 0.5 * a_max * (T_acc * T_acc);
+        double T_dec = utility::nearlyZero(v_max) ? 0.0 : v_max / a_max;
+        double L_dec = -0.5 * a_max * (T_dec * T_dec) + v_max * T_dec;
+        double L_coast = total_length - L_acc - L_dec;
+        double T_coast = utility::nearlyZero(v_max) ? 0.0 : L_coast / v_max;
+
+        if (profile > 0 || L_coast >= 0.0 || std::abs(L_coast) < 1e-6) {
+            return T_acc + T_coast + T_dec;
         }
+        // Closed form of the triangular profile, the peak velocity that accelerates over half the length
+        v_max = std::sqrt(total_length * a_max);
     }
-
-    return index_max;
 }
 
-void ConstantAccelerationSolver::calcTotalTimeAndDistanceSingleDoF(double& a_max, double& v_max,
-                                                                   double total_length, double& total_time,
-                                                                   size_t coordinate_id)
+template <int NumDoF>
+size_t ConstantAccelerationSolver<NumDoF>::calcSyncedPhases(const Point& diff, DoFVector& a_max_vec,
+                                                            DoFVector& v_max_vec, Phase& acc_phase,
+                                                            Phase& coast_phase, Phase& dec_phase,
+                                                            double& total_time)
 {
-    double T_acc;
-    double T_coast;
-    double T_dec;
-    double L_acc;
-    double L_coast;
-    double L_dec;
+    const size_t num_dof = diff.size();
 
-    if (utility::nearlyZero(a_max)) {
-        T_acc = 0.0;
-        L_acc = 0.0;
-    } else {
-        T_acc = v_max / a_max;
-        L_acc = 0.5 * a_max * std::pow(T_acc, 2);
-    }
-
-    if (utility::nearlyZero(v_max)) {
-        T_dec = 0.0;
-    } else {
-        T_dec = v_max / a_max;
+    // phase sync
+    // https://theses.hal.science/tel-01285383/document p.62 ff.
+    // All DoF follow one profile scaled by their length, so that they stay on the straight section. Its
+    // acceleration and velocity per length are the smallest ones any DoF allows. Taking both from the slowest DoF
+    // would exceed the velocity limit of DoF that are only slow because of their acceleration, e.g. when the
+    // linear and the angular limits differ. The longest DoF carries the profile, all DoF share its duration.
+    size_t index_longest_dof = 0;
+    double acc_per_length = std::numeric_limits<double>::infinity();
+    double vel_per_length = std::numeric_limits<double>::infinity();
+    size_t num_moving_dof = 0;
+    for (size_t i = 0; i < num_dof; i++) {
+        double length = std::abs(diff[i]);
+        if (length > std::abs(diff[index_longest_dof])) {
+            index_longest_dof = i;
+        }
+        if (utility::nearlyZero(length)) {
+            continue;
+        }
+        acc_per_length = std::min(acc_per_length, a_max_vec[i] / length);
+        vel_per_length = std::min(vel_per_length, v_max_vec[i] / length);
+        ++num_moving_dof;
     }
 
-    L_dec = -0.5 * a_max * std::pow(T_dec, 2) + v_max * T_dec;
-
-    L_coast = total_length - L_acc - L_dec;
-    if (utility::nearlyZero(v_max)) {
-        T_coast = 0.0;
+    total_time = 0.0;
+    if (num_moving_dof == 0) {
+        acc_per_length = 0.0;
+        vel_per_length = 0.0;
     } else {
-        T_coast = L_coast / v_max;
-    }
-
-    total_time = T_acc + T_coast + T_dec;
-
-    if (L_coast < 0.0 && !(std::abs(L_coast) < 1e-6)) {
-        double v_max_reduced = std::sqrt(total_length * a_max);
-
-        logger_.log("[Section Nr." + std::to_string(current_section_id) + "][Coord. Nr."
-                        + std::to_string(coordinate_id) + "] KinematicSolver: Decreasing maximum velocity from "
-                        + std::to_string(v_max) + " to " + std::to_string(v_max_reduced),
-                    Logger::INFO);
-
-        calcTotalTimeAndDistanceSingleDoF(a_max, v_max_reduced, total_length, total_time, coordinate_id);
-        v_max = v_max_reduced;
-    }
-}
-
-void ConstantAccelerationSolver::calcTimesAndLengthsMultiDoF(Phase& acc_phase, Phase& coast_phase,
-                                                             Phase& dec_phase,
-                                                             std::vector<double>& total_time_per_dof,
-                                                             std::vector<double>& total_length_per_dof, Point diff,
-                                                             std::vector<double>& a_max_vec,
-                                                             std::vector<double>& v_max_vec)
-{
-    for (size_t i = 0; i < diff.size(); i++) {
-        double total_length_dof = std::abs(diff[i]);
-        double total_time_dof = 0.0;
-
-        calcTotalTimeAndDistanceSingleDoF(a_max_vec[i], v_max_vec[i], total_length_dof, total_time_dof, i);
-
-        total_time_per_dof.push_back(total_time_dof);
-        total_length_per_dof.push_back(total_length_dof);
+        double length_longest = std::abs(diff[index_longest_dof]);
+        double v_max_longest = vel_per_length * length_longest;
+        total_time = calcTotalTimeSingleDoF(acc_per_length * length_longest, v_max_longest, length_longest);
+        if (v_max_longest != vel_per_length * length_longest) {
+            // Every moving DoF follows the decreased profile
+            double decreased_fraction = v_max_longest / (vel_per_length * length_longest);
+            vel_per_length = v_max_longest / length_longest;
+            logger_.logRecord({ SECTION_VELOCITY_DECREASED, Logger::INFO, static_cast<int>(current_section_id),
+                                -1, { static_cast<double>(num_moving_dof), decreased_fraction } });
+        }
     }
 
-    int index_slowest_dof = findIndexOfMax(total_time_per_dof);
-
-    // phase sync
-    // https://theses.hal.science/tel-01285383/document p.62 ff.
-    for (size_t i = 0; i < diff.size(); i++) {
-        double lambda = 0.0;  // lambda is defined in theses
-        if (!utility::nearlyZero(total_length_per_dof[index_slowest_dof])) {
-            lambda = total_length_per_dof[i] / total_length_per_dof[index_slowest_dof];
+    double acc_length_squared = 0.0;
+    double coast_length_squared = 0.0;
+    double dec_length_squared = 0.0;
+    for (size_t i = 0; i < num_dof; i++) {
+        a_max_vec[i] = acc_per_length * std::abs(diff[i]);
+        v_max_vec[i] = vel_per_length * std::abs(diff[i]);
+
+        PhaseDoF& acc_dof = acc_phase.components[i];
+        PhaseDoF& coast_dof = coast_phase.components[i];
+        PhaseDoF& dec_dof = dec_phase.components[i];
+        calcPhaseTimeAndDistance(a_max_vec[i], v_max_vec[i], std::abs(diff[i]), acc_dof, coast_dof, dec_dof);
+
+        // All DoF share the durations of their phases, or stand still with zero durations
+        if (utility::nearlyZero(acc_phase.duration) && !utility::nearlyZero(acc_dof.duration)) {
+            acc_phase.duration = acc_dof.duration;
         }
-
-        double acc_scaling_factor = 0.0;
-        double vel_scaling_factor = 0.0;
-        if (!utility::nearlyZero(a_max_vec[i])) {
-            acc_scaling_factor = a_max_vec[index_slowest_dof] / a_max_vec[i];
+        if (utility::nearlyZero(coast_phase.duration) && !utility::nearlyZero(coast_dof.duration)) {
+            coast_phase.duration = coast_dof.duration;
         }
-        if (!utility::nearlyZero(v_max_vec[i])) {
-            vel_scaling_factor = v_max_vec[index_slowest_dof] / v_max_vec[i];
+        if (utility::nearlyZero(dec_phase.duration) && !utility::nearlyZero(dec_dof.duration)) {
+            dec_phase.duration = dec_dof.duration;
         }
-
-        a_max_vec[i] *= lambda * acc_scaling_factor;
-        v_max_vec[i] *= lambda * vel_scaling_factor;
-
-        double section_length = std::abs(diff[i]);
-        PhaseDoF acc_phase_single_dof, coast_phase_single_dof, dec_phase_single_dof;
-        calcPhaseTimeAndDistance(a_max_vec[i], v_max_vec[i], section_length, acc_phase_single_dof,
-                                 coast_phase_single_dof, dec_phase_single_dof);
-
-        acc_phase.components.push_back(acc_phase_single_dof);
-        coast_phase.components.push_back(coast_phase_single_dof);
-        dec_phase.components.push_back(dec_phase_single_dof);
+        acc_length_squared += acc_dof.length * acc_dof.length;
+        coast_length_squared += coast_dof.length * coast_dof.length;
+        dec_length_squared += dec_dof.length * dec_dof.length;
     }
 
-    // Find the first component duration that is not 0.0 because all of them have the same value or 0.0
-    auto it_acc
-        = std::find_if(acc_phase.components.begin(), acc_phase.components.end(),
-                       [](const PhaseDoF& phase_dof) { return !(utility::nearlyZero(phase_dof.duration)); });
-    if (it_acc != acc_phase.components.end()) {
-        acc_phase.duration = it_acc->duration;
-    }
+    acc_phase.type = PhaseType::ConstantAcceleration;
+    acc_phase.length = std::sqrt(acc_length_squared);
 
-    auto it_coast
-        = std::find_if(coast_phase.components.begin(), coast_phase.components.end(),
-                       [](const PhaseDoF& phase_dof) { return !(utility::nearlyZero(phase_dof.duration)); });
-    if (it_coast != coast_phase.components.end()) {
-        coast_phase.duration = it_coast->duration;
-    }
+    coast_phase.type = PhaseType::ConstantVelocity;
+    coast_phase.t_start = acc_phase.duration;
+    coast_phase.length = std::sqrt(coast_length_squared);
+    coast_phase.distance_p_start = acc_phase.length;
 
-    auto it_dec
-        = std::find_if(dec_phase.components.begin(), dec_phase.components.end(),
-                       [](const PhaseDoF& phase_dof) { return !(utility::nearlyZero(phase_dof.duration)); });
-    if (it_dec != dec_phase.components.end()) {
-        dec_phase.duration = it_dec->duration;
-    }
+    dec_phase.type = PhaseType::ConstantDeacceleration;
+    dec_phase.t_start = coast_phase.duration + coast_phase.t_start;
+    dec_phase.length = std::sqrt(dec_length_squared);
+    dec_phase.distance_p_start = coast_phase.distance_p_start + coast_phase.length;
+
+    return index_longest_dof;
 }
 
-Section ConstantAccelerationSolver::calcSection(Point& p_start_ref, Point& p_end_ref,
-                                                SectionConstraint constraint_copy, size_t section_id)
+template <int NumDoF>
+Section ConstantAccelerationSolver<NumDoF>::calcSection(Point& p_start_ref, Point& p_end_ref,
+                                                        SectionConstraint constraint_copy, size_t section_id)
 {
-    current_section_id = section_id;
-
-    Section section(p_start_ref, p_end_ref, constraint_copy, section_id);
+    SOTG_TRACE_ZONE(tracer_, "ConstantAccelerationSolver::calcSection");
 
-    std::vector<double> reduced_acceleration_per_dof;
-    std::vector<double> reduced_velocity_per_dof;
+    current_section_id = section_id;
 
-    calcAccAndVelPerDoF(section, reduced_acceleration_per_dof, reduced_velocity_per_dof);
+    Section::allocator_type alloc(memory_resource_);
+    Section section(p_start_ref, p_end_ref, constraint_copy, section_id, alloc);
 
-    Point p_start = section.getStartPoint();
-    Point p_end = section.getEndPoint();
-    Point diff = p_end - p_start;
+    if (orientation_interpolation_ == QUATERNION_SLERP && p_start_ref.getOrientationIndex() != -1) {
+        setRotationVectorDifference(section);
+    }
 
-    std::vector<double> total_time_per_dof;
-    std::vector<double> total_length_per_dof;
-    std::vector<Phase> phases;
-    Phase acc_phase, coast_phase, dec_phase;
+    const size_t num_dof = getNumDoF(section);
+    DoFVector reduced_acceleration_per_dof = makeDoFVector(num_dof);
+    DoFVector reduced_velocity_per_dof = makeDoFVector(num_dof);
 
-    calcTimesAndLengthsMultiDoF(acc_phase, coast_phase, dec_phase, total_time_per_dof, total_length_per_dof, diff,
-                                reduced_acceleration_per_dof, reduced_velocity_per_dof);
+    calcAccAndVelPerDoF(section, reduced_acceleration_per_dof, reduced_velocity_per_dof);
 
-    int index_slowest_dof = findIndexOfMax(total_time_per_dof);
-    double T_total = total_time_per_dof[index_slowest_dof];
-    section.setIndexSlowestDoF(index_slowest_dof);
+    // The phases are filled in place, their components share one allocation of the section
+    std::array<Phase, 3>& phases = section.resetPhases(num_dof);
+    double T_total = 0.0;
+    size_t index_longest_dof = calcSyncedPhases(section.getDifference(), reduced_acceleration_per_dof,
+                                                reduced_velocity_per_dof, phases[0], phases[1], phases[2], T_total);
+    section.setIndexLongestDoF(index_longest_dof);
     section.setDuration(T_total);
 
-    acc_phase.type = PhaseType::ConstantAcceleration;
-    acc_phase.length = calcPhaseLength(acc_phase);
-    phases.push_back(acc_phase);
-
-    coast_phase.type = PhaseType::ConstantVelocity;
-    coast_phase.t_start = acc_phase.duration;
-    coast_phase.length = calcPhaseLength(coast_phase);
-    coast_phase.distance_p_start = acc_phase.length;
-    phases.push_back(coast_phase);
-
-    dec_phase.type = PhaseType::ConstantDeacceleration;
-    dec_phase.t_start = coast_phase.duration + coast_phase.t_start;
-    dec_phase.length = calcPhaseLength(dec_phase);
-    dec_phase.distance_p_start = coast_phase.distance_p_start + coast_phase.length;
-    phases.push_back(dec_phase);
-
-    section.setPhases(phases);
-
-    section.setAdaptedAcceleration(reduced_acceleration_per_dof);
-    section.setAdaptedVelocity(reduced_velocity_per_dof);
+    section.setAdaptedAcceleration(reduced_acceleration_per_dof.begin(), reduced_acceleration_per_dof.end());
+    section.setAdaptedVelocity(reduced_velocity_per_dof.begin(), reduced_velocity_per_dof.end());
 
     return section;
 }
 
-double calcVecNorm(const std::vector<double>& vec)  // into util
+double calcVecNorm(const std::pmr::vector<double>& vec)  // into util
 {
     double sum = 0.0;
     for (auto& component : vec) {
@@ -320,22 +360,23 @@ double calcVecNorm(const std::vector<double>& vec)  // into util
     return std::sqrt(sum);
 }
 
-void ConstantAccelerationSolver::calcPreBlendParams(double blending_dist_pre, const Section& pre_section,
-                                                    Point& A_blend, double& T_blend,
-                                                    double& vel_pre_blend_magnitude,
-                                                    double& absolute_blend_start_time_with_shift)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPreBlendParams(double blending_dist_pre, const Section& pre_section,
+                                                            Point& A_blend, double& T_blend,
+                                                            double& vel_pre_blend_magnitude,
+                                                            double& absolute_blend_start_time_with_shift)
 {
     const Point& A = pre_section.getStartPoint();
     const Point& AB = pre_section.getDifference();
     double length_AB = pre_section.getLength();
 
-    A_blend = A + AB * ((length_AB - blending_dist_pre) / length_AB);
+    A_blend.setValues(A.asVector<VECTOR_SIZE>()
+                      + AB.asVector<VECTOR_SIZE>() * ((length_AB - blending_dist_pre) / length_AB));
+    A_blend.setOrientationIndex(A.getOrientationIndex());
 
     double absolute_blend_start_time_without_shift;
-    Point vel_pre_blend;
-    calcVelAndTimeByDistance(pre_section, length_AB - blending_dist_pre, vel_pre_blend,
+    calcVelAndTimeByDistance(pre_section, length_AB - blending_dist_pre, vel_pre_blend_magnitude,
                              absolute_blend_start_time_without_shift);
-    vel_pre_blend_magnitude = vel_pre_blend.norm();
 
     if (!utility::nearlyZero(vel_pre_blend_magnitude)) {
         T_blend = 2 * blending_dist_pre / vel_pre_blend_magnitude;
@@ -346,10 +387,12 @@ void ConstantAccelerationSolver::calcPreBlendParams(double blending_dist_pre, co
     absolute_blend_start_time_with_shift = absolute_blend_start_time_without_shift - pre_section.getTimeShift();
 }
 
-void ConstantAccelerationSolver::calcPostBlendParams(double blending_dist_post, const Section& post_section,
-                                                     Point& C_blend, double& T_blend,
-                                                     double& vel_post_blend_magnitude,
-                                                     double& absolute_blend_end_time_without_shift)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPostBlendParams(double blending_dist_post,
+                                                             const Section& post_section,
+                                                             Point& C_blend, double& T_blend,
+                                                             double& vel_post_blend_magnitude,
+                                                             double& absolute_blend_end_time_without_shift)
 {
     const Point& B = post_section.getStartPoint();
     const Point& BC = post_section.getDifference();
@@ -358,13 +401,13 @@ void ConstantAccelerationSolver::calcPostBlendParams(double blending_dist_post,
     if (utility::nearlyZero(length_BC)) {
         C_blend = B;
     } else {
-        C_blend = B + BC * (blending_dist_post / length_BC);
+        C_blend.setValues(B.asVector<VECTOR_SIZE>()
+                          + BC.asVector<VECTOR_SIZE>() * (blending_dist_post / length_BC));
+        C_blend.setOrientationIndex(B.getOrientationIndex());
     }
 
-    Point vel_post_blend;
-    calcVelAndTimeByDistance(post_section, blending_dist_post, vel_post_blend,
+    calcVelAndTimeByDistance(post_section, blending_dist_post, vel_post_blend_magnitude,
                              absolute_blend_end_time_without_shift);
-    vel_post_blend_magnitude = vel_post_blend.norm();
 
     if (!utility::nearlyZero(vel_post_blend_magnitude)) {
         T_blend = 2 * blending_dist_post / vel_post_blend_magnitude;
@@ -373,11 +416,14 @@ void ConstantAccelerationSolver::calcPostBlendParams(double blending_dist_post,
     }
 }
 
-void ConstantAccelerationSolver::calcSecondBlendingDist(double T_blend, double T_acc_second,
-                                                        double a_max_magnitude_second,
-                                                        double vel_first_blend_magnitude,
-                                                        double blending_dist_first, double& blending_dist_second,
-                                                        [[maybe_unused]] size_t segment_id)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcSecondBlendingDist(double T_blend, double T_acc_second,
+                                                                double a_max_magnitude_second,
+                                                                double vel_first_blend_magnitude,
+                                                                double blending_dist_first,
+                                                                double& blending_dist_second,
+                                                                [[maybe_unused]] size_t segment_id,
+                                                                bool log_records)
 {
     if (utility::nearlyZero(vel_first_blend_magnitude)) {
         blending_dist_second = 0.0;
@@ -386,33 +432,33 @@ void ConstantAccelerationSolver::calcSecondBlendingDist(double T_blend, double T
 
     // If "second" values are post values, the "first" values will be pre values. And vice versa
     if (T_blend < T_acc_second) {
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Blending into acceleration phase",
-                    Logger::DEBUG);
+        if (log_records) {
+            logger_.logRecord({ BLEND_INTO_ACCELERATION_PHASE, Logger::DEBUG, static_cast<int>(segment_id) });
+        }
 
         blending_dist_second = 2 * std::pow(blending_dist_first, 2) * a_max_magnitude_second
                                / std::pow(vel_first_blend_magnitude, 2);
     } else {
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Blending into constant velocity phase",
-                    Logger::DEBUG);
+        if (log_records) {
+            logger_.logRecord({ BLEND_INTO_CONSTANT_VELOCITY_PHASE, Logger::DEBUG, static_cast<int>(segment_id) });
+        }
 
         blending_dist_second
             = blending_dist_first * a_max_magnitude_second * T_acc_second / vel_first_blend_magnitude;
     }
 }
 
-void ConstantAccelerationSolver::calcSegmentPreparations(const Section& pre_section, const Section& post_section,
-                                                         std::vector<double>& a_max_post,
-                                                         std::vector<double>& a_max_pre,
-                                                         double& L_acc_magnitude_post, double& T_acc_post,
-                                                         double& T_acc_pre)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcSegmentPreparations(const Section& pre_section,
+                                                                 const Section& post_section,
+                                                                 double& L_acc_magnitude_post, double& T_acc_post,
+                                                                 double& T_acc_pre)
 {
     const Phase& acc_phase_post = post_section.getPhaseByType(PhaseType::ConstantAcceleration);
     T_acc_post = acc_phase_post.duration;
-    a_max_post = post_section.getAdaptedAcceleration();
 
     const Phase& acc_phase_pre = pre_section.getPhaseByType(PhaseType::ConstantAcceleration);
     T_acc_pre = acc_phase_pre.duration;
-    a_max_pre = pre_section.getAdaptedAcceleration();
 
     L_acc_magnitude_post = 0.0;
     for (auto& component : acc_phase_post.components) {
@@ -421,38 +467,45 @@ void ConstantAccelerationSolver::calcSegmentPreparations(const Section& pre_sect
     L_acc_magnitude_post = std::sqrt(L_acc_magnitude_post);
 }
 
-bool ConstantAccelerationSolver::isBlendAccelerationTooHigh(const std::vector<double>& a_max_blend,
-                                                            const double& T_blend,
-                                                            const double& vel_pre_blend_magnitude,
-                                                            const double& vel_post_blend_magnitude,
-                                                            const Section& pre_section,
-                                                            const Section& post_section,[[maybe_unused]] size_t segment_id)
+template <int NumDoF>
+bool ConstantAccelerationSolver<NumDoF>::isBlendAccelerationTooHigh(const std::pmr::vector<double>& a_max_blend,
+                                                                    const double& T_blend,
+                                                                    const double& vel_pre_blend_magnitude,
+                                                                    const double& vel_post_blend_magnitude,
+                                                                    const Section& pre_section,
+                                                                    const Section& post_section,
+                                                                    [[maybe_unused]] size_t segment_id,
+                                                                    bool log_warnings)
 {
     const Point& dir_AB = pre_section.getDirection();
     const Point& dir_BC = post_section.getDirection();
 
-    Point blend_acc, blend_acc_linear, blend_acc_angular;
+    // On the stack if the number of DoF is known at compile time, zero without a blend duration
+    Eigen::Matrix<double, VECTOR_SIZE, 1> blend_acc;
+    blend_acc.setZero(dir_BC.size());
     double blend_acc_linear_mag, blend_acc_angular_mag;
     double a_max_linear_mag, a_max_angular_mag;
-    std::vector<double> a_max_linear, a_max_angular;
     if (!utility::nearlyZero(T_blend)) {
-        blend_acc = (dir_BC * vel_post_blend_magnitude - dir_AB * vel_pre_blend_magnitude) / T_blend;
-        size_t o_index = blend_acc.getOrientationIndex();
-
-        for (size_t i = 0; i < blend_acc.size(); ++i) {
-            if (i < o_index) {
-                blend_acc_linear.addValue(blend_acc[i]);
-                a_max_linear.push_back(a_max_blend[i]);
-            } else {
-                blend_acc_angular.addValue(blend_acc[i]);
-                a_max_angular.push_back(a_max_blend[i]);
-            }
+        blend_acc = (dir_BC.asVector<VECTOR_SIZE>() * vel_post_blend_magnitude
+                     - dir_AB.asVector<VECTOR_SIZE>() * vel_pre_blend_magnitude)
+                    / T_blend;
+        // Without orientation all DoF are linear. The squares are summed in order like Point::norm.
+        size_t num_dof = static_cast<size_t>(blend_acc.size());
+        size_t num_linear_dof = dir_BC.getOrientationIndex() == -1
+                                    ? num_dof
+                                    : std::min(static_cast<size_t>(dir_BC.getOrientationIndex()), num_dof);
+        double acc_squared[2] = { 0.0, 0.0 };
+        double a_max_squared[2] = { 0.0, 0.0 };
+        for (size_t i = 0; i < num_dof; ++i) {
+            size_t part = i < num_linear_dof ? 0 : 1;
+            acc_squared[part] += blend_acc[i] * blend_acc[i];
+            a_max_squared[part] += a_max_blend[i] * a_max_blend[i];
         }
-        blend_acc_linear_mag = blend_acc_linear.norm();
-        blend_acc_angular_mag = blend_acc_angular.norm();
+        blend_acc_linear_mag = std::sqrt(acc_squared[0]);
+        blend_acc_angular_mag = std::sqrt(acc_squared[1]);
 
-        a_max_linear_mag = calcVecNorm(a_max_linear);
-        a_max_angular_mag = calcVecNorm(a_max_angular);
+        a_max_linear_mag = std::sqrt(a_max_squared[0]);
+        a_max_angular_mag = std::sqrt(a_max_squared[1]);
 
     } else {
         blend_acc_angular_mag = 0.0;
@@ -463,36 +516,54 @@ bool ConstantAccelerationSolver::isBlendAccelerationTooHigh(const std::vector<do
     }
 
     if (blend_acc_linear_mag > a_max_linear_mag && !utility::nearlyZero(blend_acc_linear_mag)) {
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Eceeding maximum linear acceleration!",
-                    Logger::WARNING);
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Linear Acceleration magnitude would be "
-                        + std::to_string(blend_acc_linear_mag) + " m/s^2, but only "
-                        + std::to_string(a_max_linear_mag) + " m/s^2 is allowed",
-                    Logger::WARNING);
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Deactivating blending in this segment",
-                    Logger::WARNING);
+        if (log_warnings) {
+            logger_.logRecord({ BLEND_LINEAR_ACCELERATION_EXCEEDED, Logger::WARNING, static_cast<int>(segment_id),
+                                -1, { blend_acc_linear_mag, a_max_linear_mag } });
+        }
 
         return true;
     } else if (blend_acc_angular_mag > a_max_angular_mag && !utility::nearlyZero(blend_acc_angular_mag)) {
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Eceeding maximum angular acceleration!",
-                    Logger::WARNING);
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Angular Acceleration magnitude would be "
-                        + std::to_string(blend_acc_angular_mag) + " 1/s^2, but only "
-                        + std::to_string(a_max_angular_mag) + " 1/s^2 is allowed",
-                    Logger::WARNING);
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Deactivating blending in this segment",
-                    Logger::WARNING);
+        if (log_warnings) {
+            logger_.logRecord({ BLEND_ANGULAR_ACCELERATION_EXCEEDED, Logger::WARNING,
+                                static_cast<int>(segment_id), -1, { blend_acc_angular_mag, a_max_angular_mag } });
+        }
 
         return true;
-    } else
-        return false;
+    }
+
+    // Per DoF limits hold during the blend as well, the stricter one of both sections applies
+    const std::vector<double>& a_max_pre_per_dof = pre_section.getAccMaxPerDoF();
+    const std::vector<double>& a_max_post_per_dof = post_section.getAccMaxPerDoF();
+    if (!utility::nearlyZero(T_blend) && (!a_max_pre_per_dof.empty() || !a_max_post_per_dof.empty())) {
+        for (size_t i = 0; i < static_cast<size_t>(blend_acc.size()); ++i) {
+            double a_max = std::numeric_limits<double>::infinity();
+            if (!a_max_pre_per_dof.empty()) {
+                a_max = std::min(a_max, a_max_pre_per_dof[i]);
+            }
+            if (!a_max_post_per_dof.empty()) {
+                a_max = std::min(a_max, a_max_post_per_dof[i]);
+            }
+            if (std::abs(blend_acc[i]) > a_max && !utility::nearlyEqual(std::abs(blend_acc[i]), a_max, 1e-9)) {
+                if (log_warnings) {
+                    logger_.logRecord({ BLEND_DOF_ACCELERATION_EXCEEDED, Logger::WARNING,
+                                        static_cast<int>(segment_id), static_cast<int>(i),
+                                        { std::abs(blend_acc[i]), a_max } });
+                }
+                return true;
+            }
+        }
+    }
+
+    return false;
 }
 
-void ConstantAccelerationSolver::setNoBlendingParams(const Section& pre_section, const Section& post_section,
-                                                     double& T_blend, double& t_abs_start_blend_with_shift,
-                                                     double& t_abs_end_blend_without_shift, Point& A_blend,
-                                                     Point& C_blend, double& vel_pre_blend_magnitude,
-                                                     double& vel_post_blend_magnitude)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::setNoBlendingParams(const Section& pre_section,
+                                                             const Section& post_section,
+                                                             double& T_blend, double& t_abs_start_blend_with_shift,
+                                                             double& t_abs_end_blend_without_shift, Point& A_blend,
+                                                             Point& C_blend, double& vel_pre_blend_magnitude,
+                                                             double& vel_post_blend_magnitude)
 {
     T_blend = 0.0;
     t_abs_start_blend_with_shift = pre_section.getEndTime() - pre_section.getTimeShift();
@@ -503,11 +574,13 @@ void ConstantAccelerationSolver::setNoBlendingParams(const Section& pre_section,
     vel_post_blend_magnitude = 0.0;
 }
 
-std::shared_ptr<BlendSegment>
-ConstantAccelerationSolver::calcBlendSegment(Section& pre_section, Section& post_section,
-                                             const SegmentConstraint& constraint, size_t segment_id,
-                                             std::map<std::string, double>& debug_output)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcBlend(const Section& pre_section, const Section& post_section,
+                                                   const SegmentConstraint& constraint, size_t segment_id,
+                                                   BlendFallback fallback, bool log_warnings,
+                                                   BlendParameters& params, Point& A_blend, Point& C_blend)
 {
+
     /* Blending from A' to C' across B with constant acceleration
        https://www.diag.uniroma1.it/~deluca/rob1_en/14_TrajectoryPlanningCartesian.pdf
 
@@ -525,64 +598,104 @@ ConstantAccelerationSolver::calcBlendSegment(Section& pre_section, Section& post
     double length_BC = post_section.getLength();
     double a_max_magnitude_post, a_max_magnitude_pre, L_acc_magnitude_post, T_acc_post, T_acc_pre;
 
-    std::vector<double> a_max_post, a_max_pre, a_max_blend;
-
-    calcSegmentPreparations(pre_section, post_section, a_max_post, a_max_pre, L_acc_magnitude_post, T_acc_post,
-                            T_acc_pre);
+    calcSegmentPreparations(pre_section, post_section, L_acc_magnitude_post, T_acc_post, T_acc_pre);
 
+    // The limits are read from the sections instead of being copied
+    const std::pmr::vector<double>& a_max_post = post_section.getAdaptedAcceleration();
+    const std::pmr::vector<double>& a_max_pre = pre_section.getAdaptedAcceleration();
     a_max_magnitude_post = calcVecNorm(a_max_post);
     a_max_magnitude_pre = calcVecNorm(a_max_pre);
 
-    if (a_max_magnitude_post >= a_max_magnitude_pre) {
-        a_max_blend = a_max_post;
-    } else {
-        a_max_blend = a_max_pre;
-    }
+    const std::pmr::vector<double>& a_max_blend = a_max_magnitude_post >= a_max_magnitude_pre ? a_max_post
+                                                                                               : a_max_pre;
 
-    double blending_dist_pre = constraint.getBlendDistance();
+    double blending_dist_pre, blending_dist_post;
+    double T_blend, vel_pre_blend_magnitude, vel_post_blend_magnitude;
+    double t_abs_start_blend_with_shift, t_abs_end_blend_without_shift;
 
-    if (blending_dist_pre > length_AB / 2) {
-        logger_.log("[Segment Nr." + std::to_string(segment_id) + "] Pre blending distance is cropped",
-                    Logger::INFO);
+    // The fallback search below calls this repeatedly, the cropping is logged once for the requested distance
+    auto calcBlendParams = [&](double requested_blending_dist) {
+        blending_dist_pre = std::min(requested_blending_dist, length_AB / 2);
 
-        blending_dist_pre = length_AB / 2;
-    }
+        calcPreBlendParams(blending_dist_pre, pre_section, A_blend, T_blend, vel_pre_blend_magnitude,
+                           t_abs_start_blend_with_shift);
 
-    Point A_blend;
-    double T_blend, vel_pre_blend_magnitude, t_abs_start_blend_with_shift;
-    calcPreBlendParams(blending_dist_pre, pre_section, A_blend, T_blend, vel_pre_blend_magnitude,
-                       t_abs_start_blend_with_shift);
+        blending_dist_post = 0.0;
+        calcSecondBlendingDist(T_blend, T_acc_post, a_max_magnitude_post, vel_pre_blend_magnitude,
+                               blending_dist_pre, blending_dist_post, segment_id, log_warnings);
 
-    double blending_dist_post = 0.0;
-    calcSecondBlendingDist(T_blend, T_acc_post, a_max_magnitude_post, vel_pre_blend_magnitude, blending_dist_pre,
-                           blending_dist_post, segment_id);
+        if (blending_dist_post >= length_BC / 2) {
+            blending_dist_post = length_BC / 2;
 
-    Point vel_post_blend;
-    Point C_blend;
-    double vel_post_blend_magnitude;
-    double t_abs_end_blend_without_shift;
+            calcPostBlendParams(blending_dist_post, post_section, C_blend, T_blend, vel_post_blend_magnitude,
+                                t_abs_end_blend_without_shift);
 
-    if (blending_dist_post >= length_BC / 2) {
-        blending_dist_post = length_BC / 2;
+            calcSecondBlendingDist(T_blend, T_acc_pre, a_max_magnitude_pre, vel_post_blend_magnitude,
+                                   blending_dist_post, blending_dist_pre, segment_id, log_warnings);
 
-        calcPostBlendParams(blending_dist_post, post_section, C_blend, T_blend, vel_post_blend_magnitude,
-                            t_abs_end_blend_without_shift);
+            calcPreBlendParams(blending_dist_pre, pre_section, A_blend, T_blend, vel_pre_blend_magnitude,
+                               t_abs_start_blend_with_shift);
 
-        calcSecondBlendingDist(T_blend, T_acc_pre, a_max_magnitude_pre, vel_post_blend_magnitude,
-                               blending_dist_post, blending_dist_pre, segment_id);
+        } else {
+            calcPosAndVelSectionPathSpace(T_blend, post_section, C_blend, blend_velocity_);
+            vel_post_blend_magnitude = blend_velocity_.norm();
 
-        calcPreBlendParams(blending_dist_pre, pre_section, A_blend, T_blend, vel_pre_blend_magnitude,
-                           t_abs_start_blend_with_shift);
+            double vel_at_distance_magnitude;
+            calcVelAndTimeByDistance(post_section, blending_dist_post, vel_at_distance_magnitude,
+                                     t_abs_end_blend_without_shift);
+        }
+    };
 
-    } else {
-        calcPosAndVelSection(T_blend, post_section, C_blend, vel_post_blend);
-        vel_post_blend_magnitude = vel_post_blend.norm();
+    auto isBlendFeasible = [&]() {
+        return !utility::nearlyZero(T_blend)
+               && !isBlendAccelerationTooHigh(a_max_blend, T_blend, vel_pre_blend_magnitude,
+                                              vel_post_blend_magnitude, pre_section, post_section, segment_id,
+                                              false);
+    };
+
+    if (log_warnings && constraint.getBlendDistance() > length_AB / 2) {
+        logger_.logRecord({ BLEND_DISTANCE_CROPPED, Logger::INFO, static_cast<int>(segment_id) });
+    }
+    calcBlendParams(constraint.getBlendDistance());
+    double requested_blending_dist_pre = blending_dist_pre;
+    BlendFallbackResult fallback_result = WITHIN_LIMITS;
+
+    if (!utility::nearlyZero(T_blend)
+        && isBlendAccelerationTooHigh(a_max_blend, T_blend, vel_pre_blend_magnitude, vel_post_blend_magnitude,
+                                      pre_section, post_section, segment_id, false)) {
+        fallback_result = STOPPED;
+
+        // Blend velocities follow the section profiles, so a shorter blend never needs less acceleration. Where
+        // the sections coast it falls with the blend distance, bisect for the shortest feasible one.
+        if (fallback == EXTEND_BLEND_DISTANCE && requested_blending_dist_pre < length_AB / 2) {
+            calcBlendParams(length_AB / 2);
+            if (isBlendFeasible()) {
+                double infeasible_dist = requested_blending_dist_pre;
+                double feasible_dist = length_AB / 2;
+                for (int step = 0; step < NUM_BLEND_FALLBACK_STEPS; ++step) {
+                    double dist = (infeasible_dist + feasible_dist) / 2;
+                    calcBlendParams(dist);
+                    if (isBlendFeasible()) {
+                        feasible_dist = dist;
+                    } else {
+                        infeasible_dist = dist;
+                    }
+                }
+                calcBlendParams(feasible_dist);
+                fallback_result = EXTENDED_BLEND;
 
-        calcVelAndTimeByDistance(post_section, blending_dist_post, vel_post_blend, t_abs_end_blend_without_shift);
+                if (log_warnings) {
+                    logger_.logRecord({ BLEND_DISTANCE_EXTENDED, Logger::WARNING, static_cast<int>(segment_id),
+                                        -1, { requested_blending_dist_pre, blending_dist_pre } });
+                }
+            } else {
+                calcBlendParams(requested_blending_dist_pre);
+            }
+        }
     }
 
     if (isBlendAccelerationTooHigh(a_max_blend, T_blend, vel_pre_blend_magnitude, vel_post_blend_magnitude,
-                                   pre_section, post_section, segment_id)) {
+                                   pre_section, post_section, segment_id, log_warnings)) {
         setNoBlendingParams(pre_section, post_section, T_blend, t_abs_start_blend_with_shift,
                             t_abs_end_blend_without_shift, A_blend, C_blend, vel_pre_blend_magnitude,
                             vel_post_blend_magnitude);
@@ -593,30 +706,74 @@ ConstantAccelerationSolver::calcBlendSegment(Section& pre_section, Section& post
     // section is reached There are three other time frames to be aware of: Section, Segment and Phase relative
     // times denoted as t_section, t_segment and t_phase respectively
     double t_abs_end_blend_with_shift = t_abs_start_blend_with_shift + T_blend;
-    double time_shift = t_abs_end_blend_without_shift - t_abs_end_blend_with_shift;
 
-    post_section.setTimeShift(time_shift);
+    params.requested_pre_blend_distance = requested_blending_dist_pre;
+    params.pre_blend_distance = blending_dist_pre;
+    params.post_blend_distance = blending_dist_post;
+    params.pre_velocity_magnitude = vel_pre_blend_magnitude;
+    params.post_velocity_magnitude = vel_post_blend_magnitude;
+    params.duration = T_blend;
+    params.start_time = t_abs_start_blend_with_shift;
+    params.time_shift = t_abs_end_blend_without_shift - t_abs_end_blend_with_shift;
+    params.fallback_result = fallback_result;
+}
+
+template <int NumDoF>
+std::shared_ptr<BlendSegment>
+ConstantAccelerationSolver<NumDoF>::calcBlendSegment(Section& pre_section, Section& post_section,
+                                                     const SegmentConstraint& constraint, size_t segment_id)
+{
+    SOTG_TRACE_ZONE(tracer_, "ConstantAccelerationSolver::calcBlendSegment");
+
+    // The points are moved into the segment, which is allocated from the same resource
+    BlendParameters params;
+    Point A_blend{ Point::allocator_type(memory_resource_) };
+    Point C_blend{ Point::allocator_type(memory_resource_) };
+    calcBlend(pre_section, post_section, constraint, segment_id, blend_fallback_, true, params, A_blend, C_blend);
+
+    post_section.setTimeShift(params.time_shift);
 
-    std::shared_ptr<BlendSegment> segment(new BlendSegment(pre_section, post_section, constraint,
-                                                           vel_pre_blend_magnitude, vel_post_blend_magnitude,
-                                                           T_blend, t_abs_start_blend_with_shift));
+    // Segment and control block share one allocation from the memory resource of the sections
+    std::shared_ptr<BlendSegment> segment = std::allocate_shared<BlendSegment>(
+        std::pmr::polymorphic_allocator<BlendSegment>(memory_resource_), pre_section, post_section, constraint,
+        params.pre_velocity_magnitude, params.post_velocity_magnitude, params.duration, params.start_time,
+        Point::allocator_type(memory_resource_));
 
-    segment->setStartPoint(A_blend);
-    segment->setEndPoint(C_blend);
+    segment->setStartPoint(std::move(A_blend));
+    segment->setEndPoint(std::move(C_blend));
     segment->setID(segment_id);
+    segment->setFallbackResult(params.fallback_result,
+                               params.fallback_result == EXTENDED_BLEND
+                                   ? params.pre_blend_distance - params.requested_pre_blend_distance
+                                   : 0.0);
 
-    debug_output["pre_blend_dist"] = blending_dist_pre;
-    debug_output["post_blend_dist"] = blending_dist_post;
-    debug_output["pre_blend_vel"] = vel_pre_blend_magnitude;
-    debug_output["post_blend_vel"] = vel_post_blend_magnitude;
+    segment->setBlendDistances(params.requested_pre_blend_distance, params.pre_blend_distance,
+                               params.post_blend_distance);
 
     return segment;
 }
 
-void ConstantAccelerationSolver::calcPosAndVelSingleDoFLinear(double section_dof_length, const Phase& phase,
-                                                              double phase_distance_to_p_start, double t_phase,
-                                                              double a_max_reduced, double v_max_reduced,
-                                                              double& pos, double& vel) const
+template <int NumDoF>
+BlendParameters ConstantAccelerationSolver<NumDoF>::calcBlendParameters(const Section& pre_section,
+                                                                        const Section& post_section,
+                                                                        const SegmentConstraint& constraint,
+                                                                        size_t segment_id, bool log_warnings)
+{
+    SOTG_TRACE_ZONE(tracer_, "ConstantAccelerationSolver::calcBlendParameters");
+
+    BlendParameters params;
+    calcBlend(pre_section, post_section, constraint, segment_id, STOP_AT_CORNER, log_warnings, params,
+              candidate_start_point_, candidate_end_point_);
+    return params;
+}
+
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPosAndVelSingleDoFLinear(double section_dof_length,
+                                                                      const Phase& phase,
+                                                                      double phase_distance_to_p_start,
+                                                                      double t_phase,
+                                                                      double a_max_reduced, double v_max_reduced,
+                                                                      double& pos, double& vel) const
 {
     double p_i{0}, v_i{0};
     if (phase.type == PhaseType::ConstantAcceleration) {
@@ -637,13 +794,14 @@ void ConstantAccelerationSolver::calcPosAndVelSingleDoFLinear(double section_dof
     vel = v_i;
 }
 
-void ConstantAccelerationSolver::calcVelAndTimeByDistance(const Section& section, double distance,
-                                                          Point& velocity_per_dof, double& t_abs)
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcVelAndTimeByDistance(const Section& section, double distance,
+                                                                  double& velocity_magnitude, double& t_abs)
 {
     const Point& dir = section.getDirection();
 
-    std::vector<double> a_max_vec = section.getAdaptedAcceleration();
-    std::vector<double> v_max_vec = section.getAdaptedVelocity();
+    const std::pmr::vector<double>& a_max_vec = section.getAdaptedAcceleration();
+    const std::pmr::vector<double>& v_max_vec = section.getAdaptedVelocity();
 
     const Phase& phase = section.getPhaseByDistance(distance);
 
@@ -683,71 +841,198 @@ void ConstantAccelerationSolver::calcVelAndTimeByDistance(const Section& section
     double t_section_blend_start = t_phase + phase.t_start;
     t_abs = t_section_blend_start + section.getStartTime();
 
-    // calculate velocity per dof at time when distance is reached
+    // calculate velocity per dof at time when distance is reached, the squares are summed in order like
+    // Point::norm
 
     double section_length = section.getLength();
+    double velocity_squared = 0.0;
     for (size_t i = 0; i < dir.size(); ++i) {
         double section_dof_length = dir[i] * section_length;
         double _, velocity;
         calcPosAndVelSingleDoFLinear(section_dof_length, phase, phase.components[i].distance_p_start, t_phase,
                                      a_max_vec[i], v_max_vec[i], _, velocity);
-        velocity_per_dof.addValue(velocity);
+        velocity_squared += velocity * velocity;
     }
+    velocity_magnitude = std::sqrt(velocity_squared);
 }
 
-void ConstantAccelerationSolver::calcPosAndVelLinearSegment(double t_section, const LinearSegment& segment,
-                                                            Point& pos, Point& vel) const
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPosAndVelLinearSegment(double t_section, const LinearSegment& segment,
+                                                                    Point& pos, Point& vel) const
 {
     const Section& section = segment.getSection();
 
     calcPosAndVelSection(t_section, section, pos, vel);
 }
 
-void ConstantAccelerationSolver::calcPosAndVelBlendSegment(double t_segment, const BlendSegment& segment,
-                                                           Point& pos, Point& vel) const
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPosAndVelBlendSegment(double t_segment, const BlendSegment& segment,
+                                                                   Point& pos, Point& vel) const
 {
-    Point dir_AB = segment.getPreBlendDirection();
-    Point dir_BC = segment.getPostBlendDirection();
+    const Point& dir_AB = segment.getPreBlendDirection();
+    const Point& dir_BC = segment.getPostBlendDirection();
 
     double duration = segment.getDuration();
 
-    Point A_blend = segment.getStartPoint();
+    const Point& A_blend = segment.getStartPoint();
     double vel_blend_pre_magnitude = segment.getPreBlendVelocityMagnitude();
     double vel_blend_post_magnitude = segment.getPostBlendVelocityMagnitude();
 
-    pos = A_blend + dir_AB * vel_blend_pre_magnitude * t_segment
-          + (dir_BC * vel_blend_post_magnitude - dir_AB * vel_blend_pre_magnitude) * std::pow(t_segment, 2)
-                / (2 * duration);
-
-    vel = dir_AB * vel_blend_pre_magnitude
-          + (dir_BC * vel_blend_post_magnitude - dir_AB * vel_blend_pre_magnitude) * t_segment / duration;
+    // Both parabolas are fused into one pass each, written into the storage of pos and vel
+    auto vel_pre = dir_AB.asVector<VECTOR_SIZE>() * vel_blend_pre_magnitude;
+    auto vel_change = dir_BC.asVector<VECTOR_SIZE>() * vel_blend_post_magnitude - vel_pre;
+    pos.setValues(A_blend.asVector<VECTOR_SIZE>() + vel_pre * t_segment
+                  + vel_change * (t_segment * t_segment) / (2 * duration));
+    vel.setValues(vel_pre + vel_change * t_segment / duration);
     pos.setOrientationIndex(dir_AB.getOrientationIndex());
     vel.setOrientationIndex(dir_AB.getOrientationIndex());
+
+    if (orientation_interpolation_ == QUATERNION_SLERP && dir_AB.getOrientationIndex() != -1) {
+        // The angular values are rotation vectors in the frame of the blended corner B, so that both adjacent
+        // sections are straight lines through its origin
+        const Section& pre_section = segment.getPreBlendSection();
+        const Section& post_section = segment.getPostBlendSection();
+        const Point& B = post_section.getStartPoint();
+        const Point& pre_start = pre_section.getStartPoint();
+        const Point& pre_difference = pre_section.getDifference();
+        for (size_t i = dir_AB.getOrientationIndex(); i < pos.size(); ++i) {
+            *(pos.begin() + i) -= pre_start[i] + pre_difference[i];
+        }
+
+        Eigen::Vector3d reference_start = calcEulerReference(pre_section, A_blend);
+        Eigen::Vector3d reference_end = calcEulerReference(post_section, segment.getEndPoint());
+        Eigen::Vector3d reference = reference_start + (reference_end - reference_start) * (t_segment / duration);
+
+        applyRotationVector(calcQuaternion(B), reference, pos, vel);
+    }
+}
+
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPosAndVelSection(double t_section, const Section& section, Point& pos,
+                                                              Point& vel) const
+{
+    calcPosAndVelSectionPathSpace(t_section, section, pos, vel);
+
+    const Point& p_start = section.getStartPoint();
+    if (orientation_interpolation_ == QUATERNION_SLERP && p_start.getOrientationIndex() != -1) {
+        Eigen::Vector3d reference = calcEulerReference(section, pos);
+
+        // pos holds p_start plus the travelled part of the rotation vector
+        for (size_t i = p_start.getOrientationIndex(); i < pos.size(); ++i) {
+            *(pos.begin() + i) -= p_start[i];
+        }
+
+        applyRotationVector(calcQuaternion(p_start), reference, pos, vel);
+    }
 }
 
-void ConstantAccelerationSolver::calcPosAndVelSection(double t_section, const Section& section, Point& pos,
-                                                      Point& vel) const
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcPosAndVelSectionPathSpace(double t_section, const Section& section,
+                                                                       Point& pos, Point& vel) const
 {
-    Point p_start = section.getStartPoint();
-    Point p_end = section.getEndPoint();
-    Point diff = p_end - p_start;
+    const Point& p_start = section.getStartPoint();
+    const Point& diff = section.getDifference();
 
-    const std::vector<double>& a_max_vec = section.getAdaptedAcceleration();
-    const std::vector<double>& v_max_vec = section.getAdaptedVelocity();
+    const std::pmr::vector<double>& a_max_vec = section.getAdaptedAcceleration();
+    const std::pmr::vector<double>& v_max_vec = section.getAdaptedVelocity();
 
     const Phase& phase = section.getPhaseByTime(t_section);
     double t_phase = t_section - phase.t_start;
+    // Written into the storage of pos and vel, which is reused if they are evaluated repeatedly
+    pos.zeros(p_start.size());
+    vel.zeros(p_start.size());
+    Point::iterator pos_it = pos.begin();
+    Point::iterator vel_it = vel.begin();
     for (size_t i = 0; i < p_start.size(); i++) {
         double pos_relative_magnitude, vel_magnitude;
         calcPosAndVelSingleDoFLinear(std::abs(diff[i]), phase, phase.components[i].distance_p_start, t_phase,
                                      a_max_vec[i], v_max_vec[i], pos_relative_magnitude, vel_magnitude);
 
-        double pos_component = p_start[i] + pos_relative_magnitude * diff[i];
-        double vel_component = vel_magnitude * utility::sign(diff[i]);
-
-        pos.addValue(pos_component);
-        vel.addValue(vel_component);
+        pos_it[i] = p_start[i] + pos_relative_magnitude * diff[i];
+        vel_it[i] = vel_magnitude * utility::sign(diff[i]);
     }
     pos.setOrientationIndex(p_start.getOrientationIndex());
     vel.setOrientationIndex(p_start.getOrientationIndex());
 }
+
+template <int NumDoF>
+void ConstantAccelerationSolver<NumDoF>::calcStop(double t_section, double t_segment, const Segment& segment,
+                                                  StopTrajectory& stop) const
+{
+    if (orientation_interpolation_ == QUATERNION_SLERP && segment.getStartPoint().getOrientationIndex() != -1) {
+        throw std::runtime_error("Stops are only supported with component wise orientation interpolation");
+    }
+
+    StopTrajectory::Values pos{}, vel{}, acc{};
+
+    const BlendSegment* blend_segment = dynamic_cast<const BlendSegment*>(&segment);
+    const Section& stop_section
+        = blend_segment != nullptr ? blend_segment->getPostBlendSection() : segment.getSection();
+    const size_t num_dof = stop_section.getDifference().size();
+
+    if (blend_segment != nullptr) {
+        // The blend is finished before decelerating, stopping on its parabola would need a time scaling with
+        // limits that depend on the blend acceleration. Blends end on the post section with its velocity.
+        const Point& A_blend = blend_segment->getStartPoint();
+        const Point& dir_AB = blend_segment->getPreBlendDirection();
+        const Point& dir_BC = blend_segment->getPostBlendDirection();
+        double vel_pre = blend_segment->getPreBlendVelocityMagnitude();
+        double vel_post = blend_segment->getPostBlendVelocityMagnitude();
+        double duration = blend_segment->getDuration();
+        double t_blend = std::clamp(t_segment, 0.0, duration);
+
+        for (size_t i = 0; i < num_dof; ++i) {
+            acc[i] = utility::nearlyZero(duration) ? 0.0 : (dir_BC[i] * vel_post - dir_AB[i] * vel_pre) / duration;
+            pos[i] = A_blend[i] + dir_AB[i] * vel_pre * t_blend + 0.5 * acc[i] * t_blend * t_blend;
+            vel[i] = dir_AB[i] * vel_pre + acc[i] * t_blend;
+        }
+        stop.addPiece(duration - t_blend, pos, vel, acc);
+
+        double t_rest = duration - t_blend;
+        for (size_t i = 0; i < num_dof; ++i) {
+            pos[i] += vel[i] * t_rest + 0.5 * acc[i] * t_rest * t_rest;
+            vel[i] += acc[i] * t_rest;
+        }
+    } else {
+        const Point& p_start = stop_section.getStartPoint();
+        const Point& diff = stop_section.getDifference();
+        const std::pmr::vector<double>& a_max_vec = stop_section.getAdaptedAcceleration();
+        const std::pmr::vector<double>& v_max_vec = stop_section.getAdaptedVelocity();
+
+        const Phase& phase = stop_section.getPhaseByTime(std::clamp(t_section, 0.0, stop_section.getDuration()));
+        double t_phase = t_section - phase.t_start;
+        for (size_t i = 0; i < num_dof; ++i) {
+            double pos_relative_magnitude, vel_magnitude;
+            calcPosAndVelSingleDoFLinear(std::abs(diff[i]), phase, phase.components[i].distance_p_start, t_phase,
+                                         a_max_vec[i], v_max_vec[i], pos_relative_magnitude, vel_magnitude);
+            pos[i] = p_start[i] + pos_relative_magnitude * diff[i];
+            vel[i] = vel_magnitude * utility::sign(diff[i]);
+        }
+    }
+
+    // The velocity points along the section, decelerating every DoF with its adapted acceleration keeps it on the
+    // section. The section itself decelerates to its end point that way, so the stop never passes it.
+    const std::pmr::vector<double>& a_max_vec = stop_section.getAdaptedAcceleration();
+    double T_stop = 0.0;
+    for (size_t i = 0; i < num_dof; ++i) {
+        if (!utility::nearlyZero(a_max_vec[i])) {
+            T_stop = std::max(T_stop, std::abs(vel[i]) / a_max_vec[i]);
+        }
+    }
+    for (size_t i = 0; i < num_dof; ++i) {
+        acc[i] = utility::nearlyZero(T_stop) ? 0.0 : -vel[i] / T_stop;
+    }
+    stop.addPiece(T_stop, pos, vel, acc);
+}
+
+// Explicit instantiations, see MAX_FIXED_DOF
+template class SOTG::detail::ConstantAccelerationSolver<DYNAMIC_DOF>;
+template class SOTG::detail::ConstantAccelerationSolver<1>;
+template class SOTG::detail::ConstantAccelerationSolver<2>;
+template class SOTG::detail::ConstantAccelerationSolver<3>;
+template class SOTG::detail::ConstantAccelerationSolver<4>;
+template class SOTG::detail::ConstantAccelerationSolver<5>;
+template class SOTG::detail::ConstantAccelerationSolver<6>;
+template class SOTG::detail::ConstantAccelerationSolver<7>;
+template class SOTG::detail::ConstantAccelerationSolver<8>;
+template class SOTG::detail::ConstantAccelerationSolver<9>;
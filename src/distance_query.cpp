@@ -0,0 +1,88 @@
+#include "sotg/distance_query.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "sotg/segment_pieces.hpp"
+
+using namespace SOTG;
+
+DistanceQuery::DistanceQuery(size_t num_dof)
+    : num_dof_(num_dof)
+{
+    if (num_dof_ == 0) {
+        throw std::runtime_error("DistanceQuery: At least one DoF is needed");
+    }
+}
+
+void DistanceQuery::addPiece(double start_time, double end_time, const double* pos, const double* vel,
+                             const double* acc)
+{
+    if (!pieces_.empty() && start_time < pieces_.back().start_time) {
+        throw std::runtime_error("DistanceQuery: Pieces have to be added in order of their start time");
+    }
+
+    BoundingBox box(num_dof_);
+    box.extendByQuadratic(pos, vel, acc, end_time - start_time);
+    pieces_.push_back({ start_time, end_time, std::move(box), coefficients_.size() });
+    for (const double* values : { pos, vel, acc }) {
+        coefficients_.insert(coefficients_.end(), values, values + num_dof_);
+    }
+}
+
+void DistanceQuery::build() { hierarchy_.build(pieces_, num_dof_); }
+
+DistanceQueryResult DistanceQuery::findClosestApproach(const std::vector<double>& points, double start_time,
+                                                       double end_time, double max_distance) const
+{
+    DistanceQueryResult result;
+    if (pieces_.empty() || end_time < start_time) {
+        return result;
+    }
+    if (points.size() % num_dof_ != 0) {
+        throw std::runtime_error("DistanceQuery: The points have to hold " + std::to_string(num_dof_)
+                                 + " values each, but " + std::to_string(points.size()) + " values where given");
+    }
+    if (hierarchy_.isEmpty()) {
+        throw std::runtime_error("DistanceQuery: build has to be called before the first query");
+    }
+
+    double best_squared_distance = max_distance * max_distance;
+    size_t num_points = points.size() / num_dof_;
+    for (size_t point_index = 0; point_index < num_points; ++point_index) {
+        const double* point = &points[point_index * num_dof_];
+
+        auto is_closer = [&](const BoundingBox& box) {
+            return box.calcSquaredDistance(point) < best_squared_distance;
+        };
+        auto visit_leaf = [&](size_t first_piece, size_t end_piece) {
+            for (size_t i = first_piece; i < end_piece; ++i) {
+                const Piece& piece = pieces_[i];
+                if (piece.end_time < start_time || piece.start_time > end_time || !is_closer(piece.box)) {
+                    continue;
+                }
+                const double* pos = &coefficients_[piece.coefficient_index];
+                double t_piece = 0.0;
+                double squared_distance = detail::calcClosestApproach(
+                    pos, pos + num_dof_, pos + 2 * num_dof_, num_dof_, point,
+                    std::max(start_time, piece.start_time) - piece.start_time,
+                    std::min(end_time, piece.end_time) - piece.start_time, t_piece);
+                if (squared_distance < best_squared_distance) {
+                    best_squared_distance = squared_distance;
+                    result.distance = std::sqrt(squared_distance);
+                    result.time = piece.start_time + t_piece;
+                    result.point_index = point_index;
+                }
+            }
+        };
+        // The nearer child is visited first, so that it tightens the bound for the farther one
+        auto is_right_nearer = [&](const BoundingBox& left, const BoundingBox& right) {
+            return right.calcSquaredDistance(point) < left.calcSquaredDistance(point);
+        };
+        hierarchy_.traverse(start_time, end_time, is_closer, visit_leaf, is_right_nearer);
+    }
+    return result;
+}
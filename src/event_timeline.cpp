@@ -0,0 +1,32 @@
+#include "sotg/event_timeline.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace SOTG;
+
+EventTimeline::EventTimeline(std::vector<TrajectoryEvent> events)
+    : events_(std::move(events))
+{
+    std::stable_sort(events_.begin(), events_.end(),
+                     [](const TrajectoryEvent& a, const TrajectoryEvent& b) { return a.time < b.time; });
+}
+
+size_t EventTimeline::advance(double time, EventListener& listener)
+{
+    size_t num_fired = 0;
+    while (next_event_ < events_.size() && events_[next_event_].time <= time) {
+        listener.onEvent(events_[next_event_]);
+        ++next_event_;
+        ++num_fired;
+    }
+    return num_fired;
+}
+
+void EventTimeline::seek(double time)
+{
+    std::vector<TrajectoryEvent>::const_iterator it
+        = std::upper_bound(events_.begin(), events_.end(), time,
+                           [](double value, const TrajectoryEvent& event) { return value < event.time; });
+    next_event_ = static_cast<size_t>(it - events_.begin());
+}
@@ -0,0 +1,145 @@
+#include "sotg/instrumentation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace SOTG;
+
+void LatencyHistogram::record(uint64_t latency_ns)
+{
+    size_t bucket = 0;
+    while (bucket < NUM_BUCKETS - 1 && latency_ns > getBucketUpperBoundNs(bucket)) {
+        ++bucket;
+    }
+    ++bucket_counts_[bucket];
+
+    min_ns_ = count_ == 0 ? latency_ns : std::min(min_ns_, latency_ns);
+    max_ns_ = std::max(max_ns_, latency_ns);
+    sum_ns_ += latency_ns;
+    ++count_;
+}
+
+void LatencyHistogram::reset()
+{
+    bucket_counts_.fill(0);
+    count_ = 0;
+    sum_ns_ = 0;
+    min_ns_ = 0;
+    max_ns_ = 0;
+}
+
+double LatencyHistogram::getMeanNs() const
+{
+    if (count_ == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(sum_ns_) / static_cast<double>(count_);
+}
+
+uint64_t LatencyHistogram::getBucketUpperBoundNs(size_t bucket)
+{
+    return uint64_t{1} << (bucket + 6);
+}
+
+uint64_t LatencyHistogram::getQuantileUpperBoundNs(double quantile) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+
+    double rank = std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(count_));
+    uint64_t cumulative_count = 0;
+    for (size_t bucket = 0; bucket < NUM_BUCKETS - 1; ++bucket) {
+        cumulative_count += bucket_counts_[bucket];
+        if (static_cast<double>(cumulative_count) >= rank) {
+            return std::min(getBucketUpperBoundNs(bucket), max_ns_);
+        }
+    }
+    return max_ns_;
+}
+
+bool Instrumentation::isEnabled()
+{
+#ifdef INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::string Instrumentation::getOperationName(InstrumentedOperation operation)
+{
+    switch (operation) {
+    case CALC_SECTION:
+        return "calc_section";
+    case CALC_BLEND_SEGMENT:
+        return "calc_blend_segment";
+    case GENERATE_LINEAR_SEGMENTS:
+        return "generate_linear_segments";
+    case SECTION_LOOKUP:
+        return "section_lookup";
+    case SEGMENT_LOOKUP:
+        return "segment_lookup";
+    case EVALUATION:
+        return "evaluation";
+    case NUM_INSTRUMENTED_OPERATIONS:
+    default:
+        throw std::runtime_error("Instrumentation: Unknown operation " + std::to_string(operation));
+    }
+}
+
+void Instrumentation::reset()
+{
+    for (LatencyHistogram& histogram : histograms_) {
+        histogram.reset();
+    }
+}
+
+std::string Instrumentation::toPrometheus() const
+{
+    std::ostringstream out;
+    out.precision(9);
+
+    out << "# HELP sotg_operation_latency_seconds Latency of SOTG planning and evaluation steps\n";
+    out << "# TYPE sotg_operation_latency_seconds histogram\n";
+    for (int i = 0; i < NUM_INSTRUMENTED_OPERATIONS; ++i) {
+        InstrumentedOperation operation = static_cast<InstrumentedOperation>(i);
+        const LatencyHistogram& histogram = histograms_[operation];
+        std::string label = "operation=\"" + getOperationName(operation) + "\"";
+
+        uint64_t cumulative_count = 0;
+        for (size_t bucket = 0; bucket < LatencyHistogram::NUM_BUCKETS - 1; ++bucket) {
+            cumulative_count += histogram.getBucketCount(bucket);
+            out << "sotg_operation_latency_seconds_bucket{" << label << ",le=\""
+                << static_cast<double>(LatencyHistogram::getBucketUpperBoundNs(bucket)) * 1e-9 << "\"} "
+                << cumulative_count << "\n";
+        }
+        out << "sotg_operation_latency_seconds_bucket{" << label << ",le=\"+Inf\"} " << histogram.getCount()
+            << "\n";
+        out << "sotg_operation_latency_seconds_sum{" << label << "} "
+            << static_cast<double>(histogram.getSumNs()) * 1e-9 << "\n";
+        out << "sotg_operation_latency_seconds_count{" << label << "} " << histogram.getCount() << "\n";
+    }
+
+    out << "# HELP sotg_operation_latency_max_seconds Largest latency of SOTG planning and evaluation steps\n";
+    out << "# TYPE sotg_operation_latency_max_seconds gauge\n";
+    for (int i = 0; i < NUM_INSTRUMENTED_OPERATIONS; ++i) {
+        InstrumentedOperation operation = static_cast<InstrumentedOperation>(i);
+        out << "sotg_operation_latency_max_seconds{operation=\"" << getOperationName(operation) << "\"} "
+            << static_cast<double>(histograms_[operation].getMaxNs()) * 1e-9 << "\n";
+    }
+
+    return out.str();
+}
+
+void Instrumentation::writePrometheus(const std::string& file_name) const
+{
+    std::ofstream file(file_name);
+    if (!file.is_open()) {
+        throw std::runtime_error("Instrumentation: Could not open \"" + file_name + "\"");
+    }
+    file << toPrometheus();
+}
@@ -1,5 +1,7 @@
 #include "sotg/logger.hpp"
 
+#include <stdexcept>
+
 using namespace SOTG;
 
 void Logger::log( [[maybe_unused]] const std::string& message, [[maybe_unused]] MsgType type) const
@@ -22,3 +24,62 @@ void Logger::log( [[maybe_unused]] const std::string& message, [[maybe_unused]]
     }
 #endif
 }
+
+bool Logger::isEnabled([[maybe_unused]] MsgType type) const
+{
+#ifdef VERBOSE
+#ifdef DEBUG
+    return true;
+#else
+    return type != DEBUG;
+#endif
+#else
+    return false;
+#endif
+}
+
+void Logger::logRecord(const LogRecord& record) const
+{
+    if (!isEnabled(record.type)) {
+        return;
+    }
+    log(formatLogRecord(record), record.type);
+}
+
+std::string SOTG::formatLogRecord(const LogRecord& record)
+{
+    std::string segment = "[Segment Nr." + std::to_string(record.id) + "] ";
+    switch (record.event) {
+    case SECTION_VELOCITY_DECREASED:
+        return "[Section Nr." + std::to_string(record.id) + "] KinematicSolver: Decreasing maximum velocity of "
+               + std::to_string(static_cast<int>(record.values[0])) + " DoF to " + std::to_string(record.values[1])
+               + " times the allowed velocity, the section is too short";
+    case BLEND_INTO_ACCELERATION_PHASE:
+        return segment + "Blending into acceleration phase";
+    case BLEND_INTO_CONSTANT_VELOCITY_PHASE:
+        return segment + "Blending into constant velocity phase";
+    case BLEND_LINEAR_ACCELERATION_EXCEEDED:
+        return segment + "Linear Acceleration magnitude would be " + std::to_string(record.values[0])
+               + " m/s^2, but only " + std::to_string(record.values[1])
+               + " m/s^2 is allowed, deactivating blending in this segment";
+    case BLEND_ANGULAR_ACCELERATION_EXCEEDED:
+        return segment + "Angular Acceleration magnitude would be " + std::to_string(record.values[0])
+               + " 1/s^2, but only " + std::to_string(record.values[1])
+               + " 1/s^2 is allowed, deactivating blending in this segment";
+    case BLEND_DOF_ACCELERATION_EXCEEDED:
+        return segment + "Acceleration of DoF " + std::to_string(record.dof) + " would be "
+               + std::to_string(record.values[0]) + ", but only " + std::to_string(record.values[1])
+               + " is allowed, deactivating blending in this segment";
+    case BLEND_DISTANCE_CROPPED:
+        return segment + "Pre blending distance is cropped";
+    case BLEND_DISTANCE_EXTENDED:
+        return segment + "Extending blending distance from " + std::to_string(record.values[0]) + " to "
+               + std::to_string(record.values[1]) + " to keep the acceleration limits";
+    case PATH_PREPROCESSED:
+        return "TrajectoryGenerator: Preprocessing removed " + std::to_string(static_cast<int>(record.values[0]))
+               + " of " + std::to_string(static_cast<int>(record.values[1])) + " waypoints";
+    default:
+        throw std::runtime_error("SOTG Logger received a record with unknown event "
+                                 + std::to_string(record.event));
+    }
+}
@@ -0,0 +1,103 @@
+#include "sotg/orientation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace SOTG;
+using namespace detail;
+
+Eigen::Matrix3d calcSkewMatrix(const Eigen::Vector3d& vec);
+double unwrapAngle(double angle, double reference);
+
+Eigen::Matrix3d calcSkewMatrix(const Eigen::Vector3d& vec)
+{
+    Eigen::Matrix3d skew;
+    skew << 0.0, -vec.z(), vec.y(), vec.z(), 0.0, -vec.x(), -vec.y(), vec.x(), 0.0;
+    return skew;
+}
+
+// Shifts angle by multiples of 2 pi so that it is as close as possible to reference
+double unwrapAngle(double angle, double reference)
+{
+    return angle + 2.0 * EIGEN_PI * std::round((reference - angle) / (2.0 * EIGEN_PI));
+}
+
+Eigen::Quaterniond SOTG::detail::calcQuaternion(const Point& point)
+{
+    int o_index = point.getOrientationIndex();
+    if (o_index == -1 || point.size() - o_index != 3) {
+        std::ostringstream os;
+        os << point;
+        throw std::runtime_error("Quaternion interpolation needs exactly three angles (roll, pitch, yaw) after the "
+                                 "orientation index, got point "
+                                 + os.str());
+    }
+
+    double roll = point[o_index];
+    double pitch = point[o_index + 1];
+    double yaw = point[o_index + 2];
+
+    return Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()) * Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY())
+           * Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX());
+}
+
+Eigen::Vector3d SOTG::detail::calcRotationVector(const Eigen::Quaterniond& from, const Eigen::Quaterniond& to)
+{
+    Eigen::Quaterniond relative = from.conjugate() * to;
+
+    // q and -q describe the same orientation, the one with positive w leads along the shorter arc
+    if (relative.w() < 0.0) {
+        relative.coeffs() = -relative.coeffs();
+    }
+
+    Eigen::AngleAxisd angle_axis(relative);
+    return angle_axis.axis() * angle_axis.angle();
+}
+
+void SOTG::detail::applyRotationVector(const Eigen::Quaterniond& reference, const Eigen::Vector3d& reference_angles,
+                                       Point& pos, Point& vel)
+{
+    size_t o_index = pos.getOrientationIndex();
+
+    Eigen::Vector3d r(pos[o_index], pos[o_index + 1], pos[o_index + 2]);
+    Eigen::Vector3d r_dot(vel[o_index], vel[o_index + 1], vel[o_index + 2]);
+
+    double angle = r.norm();
+    Eigen::Quaterniond rotation = Eigen::Quaterniond::Identity();
+    Eigen::Matrix3d jacobian = Eigen::Matrix3d::Identity();
+    if (!utility::nearlyZero(angle)) {
+        rotation = Eigen::AngleAxisd(angle, r / angle);
+
+        // Left jacobian of SO(3), maps the derivative of the rotation vector onto the angular velocity
+        Eigen::Matrix3d skew = calcSkewMatrix(r);
+        jacobian += (1.0 - std::cos(angle)) / std::pow(angle, 2) * skew
+                    + (angle - std::sin(angle)) / std::pow(angle, 3) * skew * skew;
+    }
+
+    Eigen::Quaterniond orientation = reference * rotation;
+    Eigen::Vector3d omega = reference * (jacobian * r_dot);
+
+    const Eigen::Quaterniond& q = orientation;
+    double roll = std::atan2(2.0 * (q.w() * q.x() + q.y() * q.z()), 1.0 - 2.0 * (q.x() * q.x() + q.y() * q.y()));
+    double pitch = std::asin(std::clamp(2.0 * (q.w() * q.y() - q.z() * q.x()), -1.0, 1.0));
+    double yaw = std::atan2(2.0 * (q.w() * q.z() + q.x() * q.y()), 1.0 - 2.0 * (q.y() * q.y() + q.z() * q.z()));
+
+    // omega = yaw_rate * z + pitch_rate * Rz * y + roll_rate * Rz * Ry * x, solved for the rates
+    double roll_rate = 0.0;
+    double pitch_rate = -std::sin(yaw) * omega.x() + std::cos(yaw) * omega.y();
+    if (!utility::nearlyZero(std::cos(pitch))) {
+        roll_rate = (std::cos(yaw) * omega.x() + std::sin(yaw) * omega.y()) / std::cos(pitch);
+    }
+    double yaw_rate = omega.z() + std::sin(pitch) * roll_rate;
+
+    Point::iterator pos_it = pos.begin() + o_index;
+    *pos_it++ = unwrapAngle(roll, reference_angles[0]);
+    *pos_it++ = unwrapAngle(pitch, reference_angles[1]);
+    *pos_it = unwrapAngle(yaw, reference_angles[2]);
+
+    Point::iterator vel_it = vel.begin() + o_index;
+    *vel_it++ = roll_rate;
+    *vel_it++ = pitch_rate;
+    *vel_it = yaw_rate;
+}
@@ -1,9 +1,70 @@
 #include "sotg/path.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace SOTG;
 
+double calcDistanceToLine(const Point& point, const Point& line_start, const Point& line_end);
+std::vector<double> mergeLimitsPerDoF(const std::vector<double>& first, const std::vector<double>& second);
+SectionConstraint mergeSectionConstraints(const SectionConstraint& first, const SectionConstraint& second);
+void checkOrientationIndex(int orientation_index, size_t num_values);
+
+// Distance between point and the closest point on the line segment from line_start to line_end
+double calcDistanceToLine(const Point& point, const Point& line_start, const Point& line_end)
+{
+    double length_squared = 0.0;
+    double projection = 0.0;
+    for (size_t i = 0; i < point.size(); ++i) {
+        double line_component = line_end.getValue(i) - line_start.getValue(i);
+        length_squared += line_component * line_component;
+        projection += (point.getValue(i) - line_start.getValue(i)) * line_component;
+    }
+
+    double t = 0.0;
+    if (!utility::nearlyZero(length_squared)) {
+        t = std::clamp(projection / length_squared, 0.0, 1.0);
+    }
+
+    double distance_squared = 0.0;
+    for (size_t i = 0; i < point.size(); ++i) {
+        double line_component = line_end.getValue(i) - line_start.getValue(i);
+        double diff = point.getValue(i) - (line_start.getValue(i) + t * line_component);
+        distance_squared += diff * diff;
+    }
+
+    return std::sqrt(distance_squared);
+}
+
+// The stricter limit of every DoF, a DoF without limit in one of them keeps the other one
+std::vector<double> mergeLimitsPerDoF(const std::vector<double>& first, const std::vector<double>& second)
+{
+    if (first.empty() || second.empty()) {
+        return first.empty() ? second : first;
+    }
+    if (first.size() != second.size()) {
+        throw std::runtime_error("Path: Section constraints with " + std::to_string(first.size()) + " and "
+                                 + std::to_string(second.size()) + " per DoF limits can not be merged");
+    }
+
+    std::vector<double> merged(first.size());
+    for (size_t i = 0; i < first.size(); ++i) {
+        merged[i] = std::min(first[i], second[i]);
+    }
+    return merged;
+}
+
+SectionConstraint mergeSectionConstraints(const SectionConstraint& first, const SectionConstraint& second)
+{
+    return SectionConstraint(
+        std::min(first.getAccelerationMagnitudeLinear(), second.getAccelerationMagnitudeLinear()),
+        std::min(first.getAccelerationMagnitudeAngular(), second.getAccelerationMagnitudeAngular()),
+        std::min(first.getVelocityMagnitudeLinear(), second.getVelocityMagnitudeLinear()),
+        std::min(first.getVelocityMagnitudeAngular(), second.getVelocityMagnitudeAngular()),
+        mergeLimitsPerDoF(first.getAccelerationPerDoF(), second.getAccelerationPerDoF()),
+        mergeLimitsPerDoF(first.getVelocityPerDoF(), second.getVelocityPerDoF()));
+}
+
 void Path::addPoint(Point point) {
     int point_id = waypoints_.size() + 1;
     point.setID(point_id);
@@ -50,6 +111,54 @@ void Path::addPoint(const std::vector<std::vector<double>>& old_point)
     waypoints_.push_back(new_point);
 }
 
+// Either no orientation or the three angles roll, pitch and yaw from the orientation index on
+void checkOrientationIndex(int orientation_index, size_t num_values)
+{
+    if (orientation_index != -1
+        && (orientation_index < 0 || static_cast<size_t>(orientation_index) + 3 > num_values)) {
+        throw std::runtime_error("Path: Orientation index " + std::to_string(orientation_index)
+                                 + " is invalid for waypoints with " + std::to_string(num_values)
+                                 + " values, it has to be -1 or leave three angular values");
+    }
+}
+
+Path Path::fromMatrix(const Eigen::MatrixXd& waypoints, int orientation_index)
+{
+    size_t rows = waypoints.rows();
+    size_t cols = waypoints.cols();
+    checkOrientationIndex(orientation_index, cols);
+
+    // Eigen stores column major, so the rows are gathered directly into the preallocated points
+    Path path;
+    path.waypoints_.resize(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        Point& point = path.waypoints_[row];
+        point.zeros(cols);
+        Point::iterator value_it = point.begin();
+        for (size_t col = 0; col < cols; ++col, ++value_it) {
+            *value_it = waypoints(row, col);
+        }
+        point.setOrientationIndex(orientation_index);
+        point.setID(row + 1);
+    }
+
+    return path;
+}
+
+Path Path::fromMatrix(const double* data, size_t rows, size_t cols, int orientation_index)
+{
+    checkOrientationIndex(orientation_index, cols);
+
+    Path path;
+    path.waypoints_.reserve(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        path.waypoints_.emplace_back(data + row * cols, cols, orientation_index);
+        path.waypoints_.back().setID(row + 1);
+    }
+
+    return path;
+}
+
 Point& Path::getPointReference(size_t index)
 {
     if (index > waypoints_.size() - 1) {
@@ -66,6 +175,85 @@ Point SOTG::Path::getPointValue(size_t index) const
     return waypoints_[index];
 }
 
+PreprocessingReport Path::preprocess(std::vector<SectionConstraint>& section_constraints,
+                                     std::vector<SegmentConstraint>& segment_constraints,
+                                     const PreprocessingOptions& options)
+{
+    PreprocessingReport report;
+    report.num_waypoints_before = waypoints_.size();
+
+    if (waypoints_.size() < 3) {
+        return report;
+    }
+    if (section_constraints.size() != waypoints_.size() - 1
+        || segment_constraints.size() != waypoints_.size() - 2) {
+        throw std::runtime_error("Path: Wrong amount of constraints for preprocessing, "
+                                 + std::to_string(waypoints_.size()) + " waypoints, "
+                                 + std::to_string(section_constraints.size()) + " section constraints and "
+                                 + std::to_string(segment_constraints.size()) + " segment constraints were given");
+    }
+
+    std::vector<Point> kept_waypoints;
+    std::vector<SectionConstraint> kept_section_constraints;
+    std::vector<SegmentConstraint> kept_segment_constraints;
+    kept_waypoints.reserve(waypoints_.size());
+    kept_section_constraints.reserve(section_constraints.size());
+    kept_segment_constraints.reserve(segment_constraints.size());
+
+    // Waypoints removed since the last kept one together with the deviation they are allowed to have from the
+    // line that replaces them
+    std::vector<std::pair<size_t, double>> removed_run;
+
+    kept_waypoints.push_back(waypoints_.front());
+    SectionConstraint pending_constraint = section_constraints.front();
+
+    for (size_t i = 1; i < waypoints_.size() - 1; ++i) {
+        const Point& anchor = kept_waypoints.back();
+        const Point& candidate = waypoints_[i];
+        const Point& next = waypoints_[i + 1];
+
+        double length_pre = (candidate - anchor).norm();
+        double length_post = (next - candidate).norm();
+        bool is_short = length_pre < options.min_section_length || length_post < options.min_section_length;
+
+        // Removing a corner may never cut it deeper than blending would have done
+        double blend_distance = segment_constraints[i - 1].getBlendDistance();
+        double allowed_deviation = is_short ? std::max(options.colinear_tolerance, blend_distance)
+                                            : options.colinear_tolerance;
+
+        bool removable = calcDistanceToLine(candidate, anchor, next) <= allowed_deviation;
+        for (size_t k = 0; removable && k < removed_run.size(); ++k) {
+            removable = calcDistanceToLine(waypoints_[removed_run[k].first], anchor, next)
+                        <= removed_run[k].second;
+        }
+
+        if (removable) {
+            removed_run.emplace_back(i, allowed_deviation);
+            pending_constraint = mergeSectionConstraints(pending_constraint, section_constraints[i]);
+            if (is_short) {
+                ++report.num_removed_short_sections;
+            } else {
+                ++report.num_removed_colinear;
+            }
+        } else {
+            removed_run.clear();
+            kept_waypoints.push_back(candidate);
+            kept_section_constraints.push_back(pending_constraint);
+            kept_segment_constraints.push_back(segment_constraints[i - 1]);
+            pending_constraint = section_constraints[i];
+        }
+    }
+
+    kept_waypoints.push_back(waypoints_.back());
+    kept_section_constraints.push_back(pending_constraint);
+
+    waypoints_ = std::move(kept_waypoints);
+    section_constraints = std::move(kept_section_constraints);
+    segment_constraints = std::move(kept_segment_constraints);
+
+    return report;
+}
+
 Path SOTG::Path::operator+(const Path& path)
 {
     for(size_t i = 0; i < path.size(); i++)
@@ -1,44 +1,83 @@
 #include "sotg/path_manager.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <utility>
+
+#include "sotg/segment_pieces.hpp"
 
 using namespace SOTG;
 using namespace detail;
 
+namespace {
+// Blend calculations per corner when optimizing blend distances
+constexpr int MAX_BLEND_OPTIMIZATION_STEPS = 6;
+}  // namespace
+
 PathManager::PathManager(std::shared_ptr<KinematicSolver> solver_ptr,
-                         std::vector<std::map<std::string, double>>& debug_info_vec_tg)
-    : kinematic_solver_(solver_ptr)
-    , debug_info_vec_(debug_info_vec_tg)
+                         Instrumentation& instrumentation_tg, std::pmr::memory_resource* resource)
+    : memory_resource_(resource)
+    , waypoints_(resource)
+    , sections_(resource)
+    , segments_(resource)
+    , timelines_(1)
+    , segment_lookup_hint_(segments_.end())
+    , first_unblended_section_(sections_.end())
+    , kinematic_solver_(solver_ptr)
+    , instrumentation_(instrumentation_tg)
 {
 }
 
-void PathManager::resetSections()
+void PathManager::generateSections(std::pmr::list<Point>::iterator first_waypoint, double start_time,
+                                   const std::vector<SectionConstraint>& section_constraints)
 {
-    sections_.clear();
+    std::pmr::list<Point>::iterator it_start = first_waypoint;
 
-    size_t num_sections = path_.getNumWaypoints() - 1;
-    for (size_t i = 0; i < num_sections; i++) {
-        Section section
-            = kinematic_solver_->calcSection(path_.getPointReference(i), path_.getPointReference(i + 1), section_constraints_[i], i);
+    // New sections continue the timeline of the last section, the waypoint ids are relative to it
+    const TimelineOffset* timeline = sections_.empty() ? &timelines_.front() : sections_.back().getTimeline();
 
-        sections_.push_back(section);
-    }
+    double current_time = start_time;
+    for (const SectionConstraint& constraint : section_constraints) {
+        std::pmr::list<Point>::iterator it_end = std::next(it_start);
+        {
+            SOTG_INSTRUMENT_SCOPE(instrumentation_, CALC_SECTION);
+            sections_.push_back(kinematic_solver_->calcSection(*it_start, *it_end, constraint, next_section_id_));
+        }
 
-    double current_time = 0.0;
-    for (Section& section : sections_) {
-        double duration = section.getDuration();
+        Section& section = sections_.back();
+        section.setTimeline(timeline);
         section.setStartTime(current_time);
-        current_time += duration;
+        current_time += section.getDuration();
 
 #ifdef DEBUG
         std::cout << "Section start time: " << section.getStartTime() << ", duration: " << section.getDuration()
                   << std::endl;
 #endif
+        it_start = it_end;
+        ++next_section_id_;
     }
 }
 
-void PathManager::generateBlendSegments()
+void PathManager::resetSections(const std::vector<SectionConstraint>& section_constraints, double start_time)
 {
+    SOTG_TRACE_ZONE(tracer_, "PathManager::resetSections");
+
+    sections_.clear();
+    // Nothing refers to the spliced timelines anymore
+    timelines_.erase(std::next(timelines_.begin()), timelines_.end());
+
+    generateSections(waypoints_.begin(), start_time, section_constraints);
+}
+
+void PathManager::generateBlendSegments(std::pmr::list<Section>::iterator first_post_section,
+                                        std::pmr::list<Section>::iterator end_post_section,
+                                        std::vector<SegmentConstraint>::const_iterator first_constraint,
+                                        double earliest_blend_start)
+{
+    SOTG_TRACE_ZONE(tracer_, "PathManager::generateBlendSegments");
+
     // Iterate over all corners that could be blended
     // std::iterator is neccesary because of std::list
     // If sections was a vector instead of a list the code would look like this:
@@ -50,105 +89,521 @@ void PathManager::generateBlendSegments()
     //      ...
     // }
 
-    int blend_corner_index = 0;
-    size_t blend_segment_id = 1;
-    std::list<Section>::iterator it = sections_.begin();
-    Section* last_section_addr = &(*it);
-    for (++it; it != sections_.end(); ++it) {
-        SegmentConstraint segment_constraint = segment_constraints_[blend_corner_index];
+    std::vector<SegmentConstraint>::const_iterator it_constraint = first_constraint;
+    std::pmr::list<Section>::iterator it = first_post_section;
+    Section* last_section_addr = &(*std::prev(it));
+    for (; it != end_post_section; ++it) {
+        const SegmentConstraint& segment_constraint = *it_constraint;
+
+        // There is always one linear Segment in between, ids of linear segments are even, those of blend
+        // segments odd
+        size_t blend_segment_id = 2 * last_section_addr->getID() + 1;
 
         Section* current_section_addr = &(*it);
-        std::map<std::string, double> debug_info;
-        std::shared_ptr<BlendSegment> blend_segment = kinematic_solver_->calcBlendSegment(
-            *last_section_addr, *current_section_addr, segment_constraint, blend_segment_id, debug_info);
+        SOTG_INSTRUMENT_SCOPE(instrumentation_, CALC_BLEND_SEGMENT);
+        std::shared_ptr<BlendSegment> blend_segment;
+        if (blend_max_deviation_ < 0.0) {
+            blend_segment = kinematic_solver_->calcBlendSegment(*last_section_addr, *current_section_addr,
+                                                                segment_constraint, blend_segment_id);
+        } else {
+            SegmentConstraint optimized_constraint = optimizeBlendDistance(
+                *last_section_addr, *current_section_addr, segment_constraint, blend_segment_id);
+            blend_segment = kinematic_solver_->calcBlendSegment(*last_section_addr, *current_section_addr,
+                                                                optimized_constraint, blend_segment_id);
+        }
+
+        if (blend_segment->getStartTime() < earliest_blend_start
+            && !utility::nearlyEqual(blend_segment->getStartTime(), earliest_blend_start, 1e-6)) {
+            // The blend would alter motion that was already executed, stop at the corner instead
+            blend_segment = kinematic_solver_->calcBlendSegment(*last_section_addr, *current_section_addr,
+                                                                SegmentConstraint(0.0), blend_segment_id);
+        }
+
+        blend_segment->setTimeline(&timelines_.front());
+
         last_section_addr = current_section_addr;
-        ++blend_corner_index;
-        blend_segment_id += 2;  // There is always one linear Segment in between
+        ++it_constraint;
 
-        segments_.push_back(blend_segment);
-        debug_info_vec_.push_back(debug_info);
+        segments_.push_back(std::move(blend_segment));
     }
 }
 
-void PathManager::generateLinearSegments()
+SegmentConstraint PathManager::optimizeBlendDistance(const Section& pre_section, const Section& post_section,
+                                                    const SegmentConstraint& requested,
+                                                    size_t blend_segment_id) const
 {
-    if (segments_.size() < 1) {
-        std::shared_ptr<LinearSegment> single_segment(
-            new LinearSegment(sections_.front(), sections_.front().getEndTime(), 0.0));
-        single_segment->setID(0);
+    if (utility::nearlyZero(requested.getBlendDistance())) {
+        return requested;
+    }
 
-        segments_.push_back(single_segment);
-    } else {
-        size_t lin_segment_id = 0;
-        std::list<std::shared_ptr<Segment>>::iterator it_segments;
+    // Each candidate is calculated with the solver's own blend equations, but without a segment, records or the
+    // blend fallback. The time saved at this corner is the increase of the time shift over the one of the pre
+    // section. A candidate beyond the acceleration limits is not blended, it deviates by nothing and saves
+    // nothing, and since longer blends need less acceleration the search moves on to longer ones.
+    double best_distance = 0.0;
+    double best_time_saving = 0.0;
+
+    // The deviation grows with the blend distance, the bracket [low, high] contains the largest distance within
+    // the tolerance. The solver crops longer distances anyway.
+    double low = 0.0;
+    double high = pre_section.getLength() / 2;
+    double candidate = high;
+
+    // At constant speed a blend of distance d passes the corner at d * |dir_BC - dir_AB| / 4, a good first guess
+    const Point& corner = pre_section.getEndPoint();
+    const Point& dir_AB = pre_section.getDirection();
+    const Point& dir_BC = post_section.getDirection();
+    size_t num_linear_dof
+        = corner.getOrientationIndex() == -1 ? corner.size() : static_cast<size_t>(corner.getOrientationIndex());
+    double direction_change_squared = 0.0;
+    for (size_t dof = 0; dof < num_linear_dof; ++dof) {
+        direction_change_squared += std::pow(dir_BC[dof] - dir_AB[dof], 2);
+    }
+    if (direction_change_squared > 0.0) {
+        candidate = std::min(high, 4 * blend_max_deviation_ / std::sqrt(direction_change_squared));
+    }
+
+    for (int step = 0; step < MAX_BLEND_OPTIMIZATION_STEPS; ++step) {
+        BlendParameters params = kinematic_solver_->calcBlendParameters(
+            pre_section, post_section, SegmentConstraint(candidate), blend_segment_id, false);
+        double deviation = calcBlendDeviation(params, pre_section, post_section);
+        double time_saving = params.time_shift - pre_section.getTimeShift();
+
+        if (deviation <= blend_max_deviation_) {
+            // An unblended candidate is never chosen, its time saving is only rounding. The chosen blend then
+            // keeps the limits and the blend fallback can not extend it beyond the tolerance.
+            if (params.fallback_result == WITHIN_LIMITS && time_saving > best_time_saving) {
+                best_distance = candidate;
+                best_time_saving = time_saving;
+            }
+            if (candidate >= high || deviation > 0.95 * blend_max_deviation_) {
+                // The longest possible blend is within the tolerance or the blend nearly reaches it
+                break;
+            }
+            low = candidate;
+        } else {
+            high = candidate;
+        }
+
+        // Secant step assuming the deviation is proportional to the blend distance, bisection if it leaves the
+        // bracket
+        double next_candidate = deviation > 0.0 ? candidate * blend_max_deviation_ / deviation : high;
+        if (next_candidate <= low || next_candidate >= high) {
+            next_candidate = (low + high) / 2;
+        }
+        if (high - low < 1e-3 * high) {
+            break;
+        }
+        candidate = next_candidate;
+    }
+
+    return SegmentConstraint(best_distance);
+}
 
-        // Generate linear Segments inbetween the already existing blend segments, if any exist
-        double last_t_end = 0;
-        for (it_segments = segments_.begin(); it_segments != segments_.end(); ++it_segments) {
-            std::shared_ptr<Segment> blend_segment = *it_segments;
-            Section& pre_section = blend_segment->getPreBlendSection();
+void PathManager::generateLinearSegments(std::pmr::list<std::shared_ptr<Segment>>::iterator first_blend_segment,
+                                         double start_time)
+{
+    SOTG_INSTRUMENT_SCOPE(instrumentation_, GENERATE_LINEAR_SEGMENTS);
+    SOTG_TRACE_ZONE(tracer_, "PathManager::generateLinearSegments");
 
-            double duration = blend_segment->getStartTime() - last_t_end;
-            double t_start = last_t_end;
-            std::shared_ptr<LinearSegment> segment(new LinearSegment(pre_section, duration, t_start));
+    std::pmr::list<std::shared_ptr<Segment>>::iterator it_segments;
 
-            last_t_end = blend_segment->getEndTime();
+    // Generate linear Segments inbetween the newly generated blend segments, if any exist
+    double last_t_end = start_time;
+    for (it_segments = first_blend_segment; it_segments != segments_.end(); ++it_segments) {
+        std::shared_ptr<Segment> blend_segment = *it_segments;
+        Section& pre_section = blend_segment->getPreBlendSection();
 
-            segment->setID(lin_segment_id);
-            lin_segment_id += 2;  // There is always one blend Segment in between
+        double duration = blend_segment->getStartTime() - last_t_end;
+        double t_start = last_t_end;
+        std::shared_ptr<LinearSegment> segment = std::allocate_shared<LinearSegment>(
+            std::pmr::polymorphic_allocator<LinearSegment>(memory_resource_), pre_section, duration, t_start,
+            Point::allocator_type(memory_resource_));
 
-            segments_.insert(it_segments, segment);
-        }
+        last_t_end = blend_segment->getEndTime();
 
-        // Generate the last linear Segment
-        it_segments = std::prev(segments_.end());
-        std::shared_ptr<Segment> last_blend_segment = *it_segments;
-        Section& last_section = last_blend_segment->getPostBlendSection();
+        segment->setTimeline(&timelines_.front());
+        segment->setID(2 * pre_section.getID());
 
-        double t_end_without_shift = last_section.getEndTime();
-        double t_end_with_shift = t_end_without_shift - last_section.getTimeShift();
-        double duration = t_end_with_shift - last_blend_segment->getEndTime();
+        segments_.insert(it_segments, segment);
+    }
 
-        std::shared_ptr<LinearSegment> last_segment(new LinearSegment(last_section, duration, last_t_end));
+    // Generate the last linear Segment, without any blend segments it spans the whole section. With lazy
+    // blending it ends in the first corner that is not blended yet.
+    Section& last_section = *std::prev(first_unblended_section_);
 
-        last_segment->setID(lin_segment_id);
+    double t_end_without_shift = last_section.getEndTime();
+    double t_end_with_shift = t_end_without_shift - last_section.getTimeShift();
+    double duration = t_end_with_shift - last_t_end;
 
-        segments_.push_back(last_segment);
+    std::shared_ptr<LinearSegment> last_segment = std::allocate_shared<LinearSegment>(
+        std::pmr::polymorphic_allocator<LinearSegment>(memory_resource_), last_section, duration, last_t_end,
+        Point::allocator_type(memory_resource_));
+
+    last_segment->setTimeline(&timelines_.front());
+    last_segment->setID(2 * last_section.getID());
+
+    segments_.push_back(last_segment);
 
 #ifdef DEBUG
-        for (auto& segment : segments_) {
-            std::cout << "Segment " << segment->getID() << " start time: " << segment->getStartTime()
-                      << ", duration: " << segment->getDuration() << std::endl;
-        }
+    for (auto& segment : segments_) {
+        std::cout << "Segment " << segment->getID() << " start time: " << segment->getStartTime()
+                  << ", duration: " << segment->getDuration() << std::endl;
+    }
 #endif
+}
+
+void PathManager::resetSegments(std::vector<SegmentConstraint>&& segment_constraints, double start_time)
+{
+    segments_.clear();
+    segment_lookup_hint_ = segments_.end();
+    segment_bounds_valid_ = false;
+
+    if (blend_look_ahead_ >= 0.0) {
+        // Only the linear segment of the first section is generated, blends follow in blendAhead
+        lazy_segment_constraints_ = std::move(segment_constraints);
+        next_lazy_constraint_ = 0;
+        first_unblended_section_ = std::next(sections_.begin());
+        generateLinearSegments(segments_.begin(), start_time);
+        return;
     }
+
+    first_unblended_section_ = sections_.end();
+    generateBlendSegments(std::next(sections_.begin()), sections_.end(), segment_constraints.begin(),
+                          -std::numeric_limits<double>::infinity());
+
+    generateLinearSegments(segments_.begin(), start_time);
 }
 
-void PathManager::resetSegments()
+void PathManager::resetPath(Path&& new_path, std::vector<SectionConstraint>&& new_section_constraints,
+                            std::vector<SegmentConstraint>&& new_segment_constraints)
 {
+    SOTG_TRACE_ZONE(tracer_, "PathManager::resetPath");
+
+    if (new_path.getNumWaypoints() < 2) {
+        throw std::runtime_error("PathManager: A path needs at least two waypoints, but "
+                                 + std::to_string(new_path.getNumWaypoints()) + " where given");
+    }
+    if (new_path.getNumWaypoints() != new_section_constraints.size() + 1
+        || new_path.getNumWaypoints() > new_segment_constraints.size() + 2) {
+        throw std::runtime_error("PathManager: Wrong amount of constrains to path, "
+                                 + std::to_string(new_section_constraints.size()) + " section and "
+                                 + std::to_string(new_segment_constraints.size())
+                                 + " segment constraints where given, but "
+                                 + std::to_string(new_path.getNumWaypoints() - 1) + " and "
+                                 + std::to_string(new_path.getNumWaypoints() - 2) + " are needed");
+    }
+
+    // Sections reference the old waypoints, drop them before the waypoints are replaced
+    sections_.clear();
     segments_.clear();
+    segment_lookup_hint_ = segments_.end();
+    segment_bounds_valid_ = false;
+
+    waypoints_.clear();
+    appendWaypoints(std::move(new_path));
 
-    generateBlendSegments();
+    next_section_id_ = 0;
+    resetSections(new_section_constraints, 0.0);
 
-    generateLinearSegments();
+    resetSegments(std::move(new_segment_constraints), 0.0);
 }
 
-void PathManager::resetPath(Path new_path, std::vector<SectionConstraint> new_section_constraints,
-                            std::vector<SegmentConstraint> new_segment_constraints)
+void PathManager::appendPath(Path&& new_path, std::vector<SectionConstraint>&& new_section_constraints,
+                             std::vector<SegmentConstraint>&& new_segment_constraints, double current_time)
 {
-    path_ = new_path;
-    segment_constraints_ = new_segment_constraints;
-    section_constraints_ = new_section_constraints;
+    SOTG_TRACE_ZONE(tracer_, "PathManager::appendPath");
 
-    if (path_.getNumWaypoints() != section_constraints_.size() + 1) {
-        std::runtime_error("PathPlanner: Wrong amount of constrains to path, "
-                           + std::to_string(section_constraints_.size()) + " constraints where given, but "
-                           + std::to_string(path_.getNumWaypoints()) + " are needed");
+    if (sections_.empty()) {
+        resetPath(std::move(new_path), std::move(new_section_constraints), std::move(new_segment_constraints));
+        return;
     }
+    // New corners are only blended eagerly, the remaining lazy blends have to come first
+    completeBlends();
+
+    if (new_path.getNumWaypoints() != new_section_constraints.size()
+        || new_path.getNumWaypoints() != new_segment_constraints.size()) {
+        throw std::runtime_error("PathManager: Wrong amount of constrains to append, "
+                                 + std::to_string(new_section_constraints.size()) + " section and "
+                                 + std::to_string(new_segment_constraints.size())
+                                 + " segment constraints where given, but "
+                                 + std::to_string(new_path.getNumWaypoints()) + " of each are needed");
+    }
+    if (new_path.getNumWaypoints() == 0) {
+        return;
+    }
+
+    double t_end = segments_.back()->getEndTime();
+    if (current_time >= t_end) {
+        // The trajectory already came to rest, restart from its last waypoint instead of blending into it
+        Point last_waypoint = std::move(waypoints_.back());
+        last_waypoint.setID(sections_.back().getEndWaypointID());
+        segments_.clear();
+        segment_lookup_hint_ = segments_.end();
+        segment_bounds_valid_ = false;
+        sections_.clear();
+        waypoints_.clear();
+        waypoints_.push_back(std::move(last_waypoint));
+
+        appendWaypoints(std::move(new_path));
+        resetSections(new_section_constraints, current_time);
+
+        new_segment_constraints.erase(new_segment_constraints.begin());
+        resetSegments(std::move(new_segment_constraints), current_time);
+        return;
+    }
+
+    // The last linear segment ends in the former end point, it is replaced once the junction is blended
+    double last_linear_t_start = segments_.back()->getStartTime();
+    segments_.pop_back();
+    segment_lookup_hint_ = segments_.end();
+    segment_bounds_valid_ = false;
+
+    std::pmr::list<Point>::iterator last_old_waypoint = std::prev(waypoints_.end());
+    std::pmr::list<Section>::iterator last_old_section = std::prev(sections_.end());
+    std::pmr::list<std::shared_ptr<Segment>>::iterator last_old_segment
+        = segments_.empty() ? segments_.end() : std::prev(segments_.end());
+
+    appendWaypoints(std::move(new_path));
+    generateSections(last_old_waypoint, last_old_section->getEndTime(), new_section_constraints);
+
+    generateBlendSegments(std::next(last_old_section), sections_.end(), new_segment_constraints.begin(),
+                          current_time);
+    generateLinearSegments(last_old_segment == segments_.end() ? segments_.begin() : std::next(last_old_segment),
+                           last_linear_t_start);
+}
 
-    resetSections();
+void PathManager::appendWaypoints(Path&& new_path)
+{
+    // Keep the waypoint ids of the whole path consecutive
+    int id_offset = waypoints_.empty() ? 0 : waypoints_.back().getID();
+    for (Point& point : new_path) {
+        point.setID(point.getID() + id_offset);
+        waypoints_.push_back(std::move(point));
+    }
+}
 
-    resetSegments();
+void PathManager::pushWaypoint(Point&& point, const SectionConstraint& section_constraint,
+                               const SegmentConstraint& segment_constraint)
+{
+    pending_waypoints_.push_back(std::move(point));
+    pending_section_constraints_.push_back(section_constraint);
+    pending_segment_constraints_.push_back(segment_constraint);
+}
+
+void PathManager::advanceWindow(double current_time, double planning_horizon)
+{
+    SOTG_TRACE_ZONE(tracer_, "PathManager::advanceWindow");
+
+    retireBefore(current_time);
+
+    if (sections_.empty() && pending_waypoints_.size() >= 2) {
+        // The first section of the window starts at the current time instead of zero, the first waypoint has
+        // no corner and therefore no use for its segment constraint
+        Path path;
+        path.addPoint(std::move(pending_waypoints_[0]));
+        path.addPoint(std::move(pending_waypoints_[1]));
+        std::vector<SectionConstraint> section_constraints{pending_section_constraints_[1]};
+        last_segment_constraint_ = pending_segment_constraints_[1];
+
+        for (size_t i = 0; i < 2; ++i) {
+            pending_waypoints_.pop_front();
+            pending_section_constraints_.pop_front();
+            pending_segment_constraints_.pop_front();
+        }
+
+        waypoints_.clear();
+        appendWaypoints(std::move(path));
+        resetSections(section_constraints, current_time);
+        resetSegments({}, current_time);
+    }
+
+    // Waypoints are planned one at a time, so the work per call only depends on the horizon
+    while (!sections_.empty() && !pending_waypoints_.empty()
+           && getEndTime() - current_time < planning_horizon) {
+        std::vector<SegmentConstraint> segment_constraints{last_segment_constraint_};
+        std::vector<SectionConstraint> section_constraints{pending_section_constraints_.front()};
+        Path path;
+        path.addPoint(std::move(pending_waypoints_.front()));
+        last_segment_constraint_ = pending_segment_constraints_.front();
+
+        pending_waypoints_.pop_front();
+        pending_section_constraints_.pop_front();
+        pending_segment_constraints_.pop_front();
+
+        appendPath(std::move(path), std::move(section_constraints), std::move(segment_constraints), current_time);
+    }
+}
+
+void PathManager::splice(PathManager& other, const SegmentConstraint& junction_constraint)
+{
+    SOTG_TRACE_ZONE(tracer_, "PathManager::splice");
+
+    if (&other == this) {
+        throw std::runtime_error("PathManager: A path can not be spliced into itself");
+    }
+    if (memory_resource_ != other.memory_resource_) {
+        throw std::runtime_error("PathManager: Only paths that use the same memory resource can be spliced");
+    }
+    if (sections_.empty() || other.sections_.empty()) {
+        throw std::runtime_error("PathManager: Both paths need at least one section to be spliced");
+    }
+    if (!pending_waypoints_.empty() || !other.pending_waypoints_.empty()) {
+        throw std::runtime_error("PathManager: Paths with pending waypoints can not be spliced");
+    }
+
+    completeBlends();
+    other.completeBlends();
+
+    Section& pre_section = sections_.back();
+    Section& post_section = other.sections_.front();
+    const Point& junction = pre_section.getEndPoint();
+    const Point& other_start = post_section.getStartPoint();
+    if (junction.size() != other_start.size() || !utility::nearlyZero((junction - other_start).norm())) {
+        throw std::runtime_error("PathManager: The spliced path has to start at the last waypoint of the path");
+    }
+
+    // The first segment of other has to be its untouched first section, so that the junction can be blended
+    const Segment& other_first_segment = *other.segments_.front();
+    if (dynamic_cast<const LinearSegment*>(&other_first_segment) == nullptr
+        || &other_first_segment.getSection() != &post_section
+        || !utility::nearlyZero(post_section.getTimeShift())) {
+        throw std::runtime_error("PathManager: The spliced path must not have retired any of its motion");
+    }
+
+    // Shift the root timeline of other so that its first section starts where the last one of this path ends
+    TimelineOffset& timeline = other.timelines_.front();
+    const TimelineOffset& root_timeline = timelines_.front();
+    timeline.time += pre_section.getEndTime() - post_section.getStartTime() - root_timeline.getTime();
+    timeline.section_id += static_cast<std::ptrdiff_t>(next_section_id_)
+                           - static_cast<std::ptrdiff_t>(post_section.getID()) - root_timeline.getSectionID();
+    timeline.waypoint_id
+        += pre_section.getEndWaypointID() - post_section.getStartWaypointID() - root_timeline.getWaypointID();
+    timeline.parent = &root_timeline;
+
+    std::shared_ptr<BlendSegment> blend_segment;
+    {
+        SOTG_INSTRUMENT_SCOPE(instrumentation_, CALC_BLEND_SEGMENT);
+        size_t blend_segment_id = 2 * pre_section.getID() + 1;
+        SegmentConstraint constraint
+            = blend_max_deviation_ < 0.0
+                  ? junction_constraint
+                  : optimizeBlendDistance(pre_section, post_section, junction_constraint, blend_segment_id);
+        blend_segment = kinematic_solver_->calcBlendSegment(pre_section, post_section, constraint,
+                                                            blend_segment_id);
+    }
+    blend_segment->setTimeline(&root_timeline);
+
+    // The time saved by the junction blend moves all of other, it goes into the offset instead of the time shifts
+    // of its sections
+    timeline.time -= post_section.getTimeShift();
+    post_section.setTimeShift(0.0);
+
+    // The linear segments next to the junction are cropped to the blend
+    Segment& pre_linear_segment = *segments_.back();
+    pre_linear_segment.setDuration(blend_segment->getStartTime() - pre_linear_segment.getStartTime());
+    Segment& post_linear_segment = *other.segments_.front();
+    double post_linear_t_end = post_linear_segment.getEndTime();
+    post_linear_segment.setStartTime(blend_segment->getEndTime());
+    post_linear_segment.setDuration(post_linear_t_end - blend_segment->getEndTime());
+
+    segments_.push_back(std::move(blend_segment));
+
+    waypoints_.splice(waypoints_.end(), other.waypoints_);
+    sections_.splice(sections_.end(), other.sections_);
+    segments_.splice(segments_.end(), other.segments_);
+    timelines_.splice(timelines_.end(), other.timelines_);
+
+    next_section_id_ = sections_.back().getID() + 1;
+    segment_lookup_hint_ = segments_.end();
+    segment_bounds_valid_ = false;
+
+    // other starts over with a new root timeline
+    other.timelines_.emplace_back();
+    other.clear();
+}
+
+void PathManager::blendAhead(double time)
+{
+    if (first_unblended_section_ == sections_.end()) {
+        return;
+    }
+
+    // The trailing linear segment starts where the last blend ends, everything before it is final
+    while (first_unblended_section_ != sections_.end() && segments_.back()->getStartTime() <= time) {
+        double last_linear_t_start = segments_.back()->getStartTime();
+        segments_.pop_back();
+        segment_lookup_hint_ = segments_.end();
+        segment_bounds_valid_ = false;
+        std::pmr::list<std::shared_ptr<Segment>>::iterator last_old_segment
+            = segments_.empty() ? segments_.end() : std::prev(segments_.end());
+
+        std::pmr::list<Section>::iterator post_section = first_unblended_section_++;
+        generateBlendSegments(post_section, first_unblended_section_,
+                              lazy_segment_constraints_.cbegin() + next_lazy_constraint_,
+                              -std::numeric_limits<double>::infinity());
+        ++next_lazy_constraint_;
+
+        generateLinearSegments(last_old_segment == segments_.end() ? segments_.begin()
+                                                                   : std::next(last_old_segment),
+                               last_linear_t_start);
+    }
+
+    if (first_unblended_section_ == sections_.end()) {
+        lazy_segment_constraints_.clear();
+        next_lazy_constraint_ = 0;
+    }
+}
+
+void PathManager::clear()
+{
+    // Segments and sections reference the waypoints, drop them first
+    segments_.clear();
+    segment_lookup_hint_ = segments_.end();
+    segment_bounds_valid_ = false;
+    sections_.clear();
+    waypoints_.clear();
+
+    first_unblended_section_ = sections_.end();
+    lazy_segment_constraints_.clear();
+    next_lazy_constraint_ = 0;
+    timelines_.erase(std::next(timelines_.begin()), timelines_.end());
+
+    pending_waypoints_.clear();
+    pending_section_constraints_.clear();
+    pending_segment_constraints_.clear();
+
+    next_section_id_ = 0;
+}
+
+void PathManager::retireBefore(double time)
+{
+    if (segments_.empty()) {
+        return;
+    }
+
+    // The last segment is always kept, so that the trajectory can still be evaluated at its end
+    while (segments_.size() > 1 && segments_.front()->getEndTime() < time
+           && !utility::nearlyEqual(segments_.front()->getEndTime(), time, 1e-6)) {
+        segments_.pop_front();
+        segment_lookup_hint_ = segments_.end();
+        segment_bounds_valid_ = false;
+    }
+
+    const Segment& first_segment = *segments_.front();
+    const Section* first_needed_section;
+    if (dynamic_cast<const BlendSegment*>(&first_segment) != nullptr) {
+        first_needed_section = &first_segment.getPreBlendSection();
+    } else {
+        first_needed_section = &first_segment.getSection();
+    }
+
+    while (&sections_.front() != first_needed_section) {
+        sections_.pop_front();
+    }
+    while (&waypoints_.front() != &sections_.front().getStartPoint()) {
+        waypoints_.pop_front();
+    }
 }
 
 std::ostream& PathManager::operator<<(std::ostream& out)
@@ -156,7 +611,7 @@ std::ostream& PathManager::operator<<(std::ostream& out)
     out << "[ ";
 
     if (!sections_.empty()) {
-        std::list<Section>::iterator it;
+        std::pmr::list<Section>::iterator it;
         for (it = sections_.begin(); it != std::prev(sections_.end()); ++it) {
             out << it->getStartPoint() << ", ";
         }
@@ -168,13 +623,58 @@ std::ostream& PathManager::operator<<(std::ostream& out)
     return out;
 }
 
+const SegmentBoundsTree& PathManager::getSegmentBounds()
+{
+    if (segment_bounds_valid_) {
+        return segment_bounds_;
+    }
+    SOTG_TRACE_ZONE(tracer_, "PathManager::getSegmentBounds");
+
+    size_t num_dof = sections_.empty() ? 0 : getNumPositionDoF(sections_.front());
+    std::vector<SegmentBounds> bounds;
+    std::vector<ConstantAccelerationPiece> pieces;
+    std::vector<double> pos(num_dof), vel(num_dof), acc(num_dof);
+    for (const std::shared_ptr<Segment>& segment : segments_) {
+        // Every piece is a parabola per DoF, its extrema are closed form
+        pieces.clear();
+        appendPieces(*segment, pieces);
+        if (pieces.empty()) {
+            continue;
+        }
+        SegmentBounds segment_bounds{ segment->getID(), segment->getStartTime(), segment->getEndTime(),
+                                      BoundingBox(num_dof) };
+        for (const ConstantAccelerationPiece& piece : pieces) {
+            calcPieceCoefficients(piece, *kinematic_solver_, num_dof, pos.data(), vel.data(), acc.data());
+            segment_bounds.box.extendByQuadratic(pos.data(), vel.data(), acc.data(),
+                                                 piece.end_time - piece.start_time);
+        }
+        bounds.push_back(std::move(segment_bounds));
+    }
+
+    segment_bounds_ = SegmentBoundsTree(num_dof, std::move(bounds));
+    segment_bounds_valid_ = true;
+    return segment_bounds_;
+}
+
 const Segment& PathManager::getSegmentAtTime(double time)
 {
+    SOTG_INSTRUMENT_SCOPE(instrumentation_, SEGMENT_LOOKUP);
+
+    blendAhead(time + blend_look_ahead_);
+
+    // Evaluated times mostly increase, the search continues from the last found segment unless time lies before it
+    std::pmr::list<std::shared_ptr<Segment>>::iterator it = segments_.begin();
     double last_t_end = 0.0;
-    for (std::shared_ptr<Segment> segment : segments_) {
-        double t_end = segment->getStartTime() + segment->getDuration();
+    if (segment_lookup_hint_ != segments_.end() && (*segment_lookup_hint_)->getStartTime() < time) {
+        it = segment_lookup_hint_;
+        last_t_end = (*it)->getStartTime();
+    }
+
+    for (; it != segments_.end(); ++it) {
+        double t_end = (*it)->getStartTime() + (*it)->getDuration();
         if (time > last_t_end && (time < t_end || (utility::nearlyEqual(time, t_end, 1e-6)))) {
-            return *segment;
+            segment_lookup_hint_ = it;
+            return **it;
         }
         last_t_end = t_end;
     }
@@ -188,6 +688,10 @@ const Segment& PathManager::getSegmentAtTime(double time)
 
 const Section& PathManager::getSectionAtTime(double time)
 {
+    SOTG_INSTRUMENT_SCOPE(instrumentation_, SECTION_LOOKUP);
+
+    blendAhead(time + blend_look_ahead_);
+
     double last_t_end = 0.0;
     for (const Section& section : sections_) {
         // Explanation for time_shift in the Section class
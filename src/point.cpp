@@ -4,6 +4,25 @@ using namespace SOTG;
 
 Point::Point() { }
 
+Point::Point(const allocator_type& alloc)
+    : values_(alloc)
+{
+}
+
+Point::Point(const Point& other, const allocator_type& alloc)
+    : values_(other.values_, alloc)
+    , orientation_index_(other.orientation_index_)
+    , id_(other.id_)
+{
+}
+
+Point::Point(Point&& other, const allocator_type& alloc)
+    : values_(std::move(other.values_), alloc)
+    , orientation_index_(other.orientation_index_)
+    , id_(other.id_)
+{
+}
+
 Point::Point(std::vector<Eigen::VectorXd> vec_list)
 {
     for (auto& vec : vec_list)
@@ -12,38 +31,33 @@ Point::Point(std::vector<Eigen::VectorXd> vec_list)
     setOrientationIndex(vec_list[0].size());
 }
 
+Point::Point(const double* values, size_t num_values, int orientation_index)
+    : values_(values, values + num_values)
+    , orientation_index_(orientation_index)
+{
+}
+
 Point Point::operator+(const Point& p2) const
 {
-    Point new_point;
-    if (values_.size() != p2.size())
+    if (values_.size() != p2.size()) {
         throw std::runtime_error("Error: Adding two points of different size!");
-    else {
-        if (p2.getOrientationIndex() != orientation_index_) {
-            if (p2.getOrientationIndex() != -1)
-                new_point.setOrientationIndex(p2.getOrientationIndex());
-            else if (orientation_index_ != -1)
-                new_point.setOrientationIndex(orientation_index_);
-        }
-        for (size_t i = 0; i < values_.size(); i++) {
-            new_point.addValue(values_[i] + p2.getValue(i));
-        }
-        new_point.setOrientationIndex(orientation_index_);
-        return new_point;
     }
+    Point new_point;
+    new_point.setValues(asVector() + p2.asVector());
+    new_point.setOrientationIndex(orientation_index_);
+    return new_point;
 }
 
 Point Point::operator-() const
 {
     Point new_point;
-    for (auto& value : values_)
-        new_point.addValue(-value);
+    new_point.setValues(-asVector());
     new_point.setOrientationIndex(orientation_index_);
     return new_point;
 }
 
 Point Point::operator-(const Point& p2) const
 {
-    Point new_point;
     if (values_.size() != p2.size()) {
         std::ostringstream os1, os2;
         os1 << *this;
@@ -51,19 +65,11 @@ Point Point::operator-(const Point& p2) const
 
         throw std::runtime_error("Trying to substract two points of different size!, left Point:" + os1.str()
                                  + ", right Point:" + os2.str());
-    } else {
-        if (p2.getOrientationIndex() != orientation_index_) {
-            if (p2.getOrientationIndex() != -1)
-                new_point.setOrientationIndex(p2.getOrientationIndex());
-            else if (orientation_index_ != -1)
-                new_point.setOrientationIndex(orientation_index_);
-        }
-        for (size_t i = 0; i < values_.size(); i++) {
-            new_point.addValue(values_[i] - p2.getValue(i));
-        }
-        new_point.setOrientationIndex(orientation_index_);
-        return new_point;
     }
+    Point new_point;
+    new_point.setValues(asVector() - p2.asVector());
+    new_point.setOrientationIndex(orientation_index_);
+    return new_point;
 }
 
 double Point::operator[](size_t index) const
@@ -78,15 +84,15 @@ double Point::operator[](size_t index) const
 
 double Point::norm()
 {
+    // Summed in order, Eigen's norm sums in a different order and can change the last bit
     double sum = 0.0;
-    for (auto& value : values_) {
-        sum += std::pow(value, 2);
+    for (double value : values_) {
+        sum += value * value;
     }
-
     return std::sqrt(sum);
 }
 
-void Point::zeros(size_t num_components) { values_ = std::vector<double>(num_components); }
+void Point::zeros(size_t num_components) { values_.assign(num_components, 0.0); }
 
 Point Point::operator/(const double& scalar) const
 {
@@ -97,9 +103,7 @@ Point Point::operator/(const double& scalar) const
     }
 
     Point new_point;
-    for (double value : values_) {
-        new_point.addValue(value / scalar);
-    }
+    new_point.setValues(asVector() / scalar);
     new_point.setOrientationIndex(orientation_index_);
     return new_point;
 }
@@ -107,9 +111,7 @@ Point Point::operator/(const double& scalar) const
 Point Point::operator*(const double& scalar) const
 {
     Point new_point;
-    for (double value : values_) {
-        new_point.addValue(value * scalar);
-    }
+    new_point.setValues(asVector() * scalar);
     new_point.setOrientationIndex(orientation_index_);
     return new_point;
 }
@@ -117,6 +119,7 @@ Point Point::operator*(const double& scalar) const
 Point Point::getLocation()
 {
     Point new_point;
+    new_point.values_.reserve(values_.size());
     for (size_t i = 0; i < values_.size(); ++i) {
         if (int(i) < orientation_index_)
             new_point.addValue(values_[i]);
@@ -127,6 +130,7 @@ Point Point::getLocation()
 Point Point::getOrientation()
 {
     Point new_point;
+    new_point.values_.reserve(values_.size());
     for (size_t i = 0; i < values_.size(); ++i) {
         if (int(i) >= orientation_index_)
             new_point.addValue(values_[i]);
@@ -0,0 +1,79 @@
+#include "sotg/polynomial_trajectory.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace SOTG;
+
+template <typename Scalar>
+PolynomialTrajectory<Scalar>::PolynomialTrajectory(size_t num_dof)
+    : num_dof_(num_dof)
+{
+    if (num_dof_ == 0) {
+        throw std::runtime_error("PolynomialTrajectory: At least one DoF is needed");
+    }
+}
+
+template <typename Scalar>
+void PolynomialTrajectory<Scalar>::addPiece(double start_time, const double* pos, const double* vel,
+                                            const double* acc)
+{
+    if (!start_times_.empty() && start_time < start_times_.back()) {
+        throw std::runtime_error("PolynomialTrajectory: Pieces have to be added in order of their start time");
+    }
+
+    start_times_.push_back(start_time);
+    for (const double* values : { pos, vel, acc }) {
+        for (size_t i = 0; i < num_dof_; ++i) {
+            coefficients_.push_back(static_cast<Scalar>(values[i]));
+        }
+    }
+    end_time_ = std::max(end_time_, start_time);
+}
+
+template <typename Scalar>
+void PolynomialTrajectory<Scalar>::setEndTime(double end_time)
+{
+    end_time_ = std::max(end_time, getStartTime());
+}
+
+template <typename Scalar>
+void PolynomialTrajectory<Scalar>::updateErrorBounds(double position_error, double velocity_error)
+{
+    max_position_error_ = std::max(max_position_error_, position_error);
+    max_velocity_error_ = std::max(max_velocity_error_, velocity_error);
+}
+
+template <typename Scalar>
+size_t PolynomialTrajectory<Scalar>::findPiece(double time) const
+{
+    // Last piece that starts at or before time
+    std::vector<double>::const_iterator it = std::upper_bound(start_times_.begin(), start_times_.end(), time);
+    return it == start_times_.begin() ? 0 : static_cast<size_t>(it - start_times_.begin()) - 1;
+}
+
+template <typename Scalar>
+void PolynomialTrajectory<Scalar>::calcPositionAndVelocity(double time, Scalar* pos, Scalar* vel) const
+{
+    if (start_times_.empty()) {
+        std::fill(pos, pos + num_dof_, Scalar(0));
+        std::fill(vel, vel + num_dof_, Scalar(0));
+        return;
+    }
+
+    size_t index = findPiece(time);
+    double piece_end = index + 1 < start_times_.size() ? start_times_[index + 1] : end_time_;
+    // Only the time within the piece is rounded, so its resolution does not depend on the absolute time
+    Scalar t = static_cast<Scalar>(std::clamp(time, start_times_[index], piece_end) - start_times_[index]);
+
+    const Scalar* piece_pos = &coefficients_[3 * num_dof_ * index];
+    const Scalar* piece_vel = piece_pos + num_dof_;
+    const Scalar* piece_acc = piece_vel + num_dof_;
+    for (size_t i = 0; i < num_dof_; ++i) {
+        pos[i] = piece_pos[i] + (piece_vel[i] + Scalar(0.5) * piece_acc[i] * t) * t;
+        vel[i] = piece_vel[i] + piece_acc[i] * t;
+    }
+}
+
+template class SOTG::PolynomialTrajectory<float>;
+template class SOTG::PolynomialTrajectory<double>;
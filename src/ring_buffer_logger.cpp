@@ -0,0 +1,118 @@
+#include "sotg/ring_buffer_logger.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace SOTG;
+
+RingBufferLogger::RingBufferLogger(const Logger& sink, size_t capacity, std::chrono::milliseconds drain_period)
+    : sink_(sink)
+    , drain_period_(drain_period)
+    , capacity_(2)
+{
+    if (capacity == 0) {
+        throw std::runtime_error("RingBufferLogger: The capacity must be positive");
+    }
+    // A power of two keeps the position in the buffer valid when the indices wrap around
+    while (capacity_ < capacity) {
+        capacity_ *= 2;
+    }
+    entries_.reset(new Entry[capacity_]);
+
+    drain_thread_ = std::thread(&RingBufferLogger::run, this);
+}
+
+RingBufferLogger::~RingBufferLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    condition_.notify_all();
+    drain_thread_.join();
+}
+
+RingBufferLogger::Entry* RingBufferLogger::reserveEntry() const
+{
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == capacity_) {
+        num_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &entries_[head & (capacity_ - 1)];
+}
+
+void RingBufferLogger::log(const std::string& message, MsgType type) const
+{
+    if (!isEnabled(type)) {
+        return;
+    }
+    Entry* entry = reserveEntry();
+    if (entry == nullptr) {
+        return;
+    }
+    entry->record.type = type;
+    entry->is_message = true;
+    size_t length = std::min(message.size(), MAX_MESSAGE_LENGTH);
+    std::copy_n(message.data(), length, entry->message.data());
+    entry->message[length] = '\0';
+    head_.fetch_add(1, std::memory_order_release);
+}
+
+void RingBufferLogger::logRecord(const LogRecord& record) const
+{
+    if (!isEnabled(record.type)) {
+        return;
+    }
+    Entry* entry = reserveEntry();
+    if (entry == nullptr) {
+        return;
+    }
+    entry->record = record;
+    entry->is_message = false;
+    head_.fetch_add(1, std::memory_order_release);
+}
+
+void RingBufferLogger::flush()
+{
+    size_t head = head_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    flush_requested_ = true;
+    condition_.notify_all();
+    condition_.wait(lock, [&]() { return tail_.load(std::memory_order_acquire) >= head; });
+}
+
+void RingBufferLogger::drain()
+{
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+        const Entry& entry = entries_[tail & (capacity_ - 1)];
+        try {
+            sink_.log(entry.is_message ? std::string(entry.message.data()) : formatLogRecord(entry.record),
+                      entry.record.type);
+        } catch (...) {
+            // The drain thread has no caller to report to
+            num_dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Frees the entry for the logging thread
+        tail_.store(tail + 1, std::memory_order_release);
+    }
+}
+
+void RingBufferLogger::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        lock.unlock();
+        drain();
+        lock.lock();
+
+        // Wakes a waiting flush, then sleeps until the next period unless a flush or the destructor needs it
+        condition_.notify_all();
+        condition_.wait_for(lock, drain_period_, [this]() { return stop_ || flush_requested_; });
+        flush_requested_ = false;
+    }
+    lock.unlock();
+    drain();
+}
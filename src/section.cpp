@@ -3,21 +3,110 @@
 using namespace SOTG;
 using namespace detail;
 
-Section::Section(Point& p_start_ref, Point& p_end_ref, SectionConstraint constraint_copy, size_t section_id)
+Section::Section(Point& p_start_ref, Point& p_end_ref, SectionConstraint constraint_copy, size_t section_id,
+                 const allocator_type& alloc)
     : start_point_(p_start_ref)
     , end_point_(p_end_ref)
+    , diff_(alloc)
+    , dir_(alloc)
     , constraint_(constraint_copy)
+    , phase_components_(alloc)
+    , adapted_acceleration_(alloc)
+    , adapted_velocity_(alloc)
     , id_(section_id)
 {
-    diff_ = end_point_ - start_point_;
+    size_t num_dof = start_point_.size();
+    if (end_point_.size() != num_dof) {
+        throw std::runtime_error("In section Nr." + std::to_string(section_id) + " the waypoints have "
+                                 + std::to_string(num_dof) + " and " + std::to_string(end_point_.size())
+                                 + " values");
+    }
+
+    // Difference and direction are written into their own storage, without temporary points
+    diff_.setValues(end_point_.asVector() - start_point_.asVector());
+    diff_.setOrientationIndex(end_point_.getOrientationIndex());
     length_ = diff_.norm();
+
     if (utility::nearlyZero(length_)) {
-        dir_.zeros(diff_.size());
+        dir_.zeros(num_dof);
     } else {
-        dir_ = diff_ / length_;
+        dir_.setValues(diff_.asVector() / length_);
+        dir_.setOrientationIndex(diff_.getOrientationIndex());
+    }
+}
+
+Section::Section(const Section& other, const allocator_type& alloc)
+    : start_point_(other.start_point_)
+    , end_point_(other.end_point_)
+    , diff_(other.diff_, alloc)
+    , dir_(other.dir_, alloc)
+    , length_(other.length_)
+    , constraint_(other.constraint_)
+    , phase_components_(other.phase_components_, alloc)
+    , phases_(other.phases_)
+    , index_longest_dof_(other.index_longest_dof_)
+    , adapted_acceleration_(other.adapted_acceleration_, alloc)
+    , adapted_velocity_(other.adapted_velocity_, alloc)
+    , duration_(other.duration_)
+    , start_time_(other.start_time_)
+    , id_(other.id_)
+    , time_shift_(other.time_shift_)
+    , timeline_(other.timeline_)
+{
+    bindPhaseComponents();
+}
+
+Section::Section(Section&& other, const allocator_type& alloc)
+    : start_point_(other.start_point_)
+    , end_point_(other.end_point_)
+    , diff_(std::move(other.diff_), alloc)
+    , dir_(std::move(other.dir_), alloc)
+    , length_(other.length_)
+    , constraint_(other.constraint_)
+    , phase_components_(std::move(other.phase_components_), alloc)
+    , phases_(other.phases_)
+    , index_longest_dof_(other.index_longest_dof_)
+    , adapted_acceleration_(std::move(other.adapted_acceleration_), alloc)
+    , adapted_velocity_(std::move(other.adapted_velocity_), alloc)
+    , duration_(other.duration_)
+    , start_time_(other.start_time_)
+    , id_(other.id_)
+    , time_shift_(other.time_shift_)
+    , timeline_(other.timeline_)
+{
+    bindPhaseComponents();
+}
+
+Section::Section(const Section& other)
+    : Section(other, allocator_type())
+{
+}
+
+std::array<Phase, 3>& Section::resetPhases(size_t num_dof)
+{
+    phases_ = {};
+    phase_components_.assign(phases_.size() * num_dof, PhaseDoF());
+    bindPhaseComponents();
+    return phases_;
+}
+
+void Section::bindPhaseComponents()
+{
+    size_t num_dof = phase_components_.size() / phases_.size();
+    for (size_t i = 0; i < phases_.size(); ++i) {
+        phases_[i].components = PhaseComponents(phase_components_.data() + i * num_dof, num_dof);
     }
 }
 
+void Section::setTimeline(const TimelineOffset* timeline)
+{
+    double start_time = getStartTime();
+    size_t id = getID();
+    timeline_ = timeline;
+    setStartTime(start_time);
+    setID(id);
+}
+
 const Phase& Section::getPhaseByTime(double time) const
 {
     double previous_time = 0.0;
@@ -30,7 +119,7 @@ const Phase& Section::getPhaseByTime(double time) const
     if (utility::nearlyEqual(time, previous_time, 1e-6)) {
         return phases_.back();
     } else {
-        throw std::runtime_error("In section Nr." + std::to_string(id_)
+        throw std::runtime_error("In section Nr." + std::to_string(getID())
                                  + " a phase at time: " + std::to_string(time)
                                  + " was requested, which is outside the section. Total section time: "
                                  + std::to_string(previous_time));
@@ -44,7 +133,7 @@ const Phase& Section::getPhaseByType(PhaseType type) const
     if (it != phases_.end()) {
         return *it;
     } else {
-        throw std::runtime_error("In section Nr." + std::to_string(id_) + " a phase of type: " + ToString(type)
+        throw std::runtime_error("In section Nr." + std::to_string(getID()) + " a phase of type: " + ToString(type)
                                  + " was requested, but isn't available.");
     }
 }
@@ -66,7 +155,7 @@ const Phase& Section::getPhaseByDistance(double distance) const
         return phases_.back();
     } else {
         throw std::runtime_error(
-            "In section Nr." + std::to_string(id_) + " a phase at distance: " + std::to_string(distance)
+            "In section Nr." + std::to_string(getID()) + " a phase at distance: " + std::to_string(distance)
             + " was requested, which is outside the section. Section length: " + std::to_string(last_distance));
     }
 }
\ No newline at end of file
@@ -1,7 +1,23 @@
 #include "sotg/section_constraint.hpp"
 
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 using namespace SOTG;
 
+void checkLimitsPerDoF(const std::vector<double>& limits, const std::string& name);
+
+void checkLimitsPerDoF(const std::vector<double>& limits, const std::string& name)
+{
+    for (size_t i = 0; i < limits.size(); ++i) {
+        if (!(limits[i] > 0.0)) {
+            throw std::runtime_error("SectionConstraint: The " + name + " limit of DoF " + std::to_string(i)
+                                     + " must be positive, but is " + std::to_string(limits[i]));
+        }
+    }
+}
+
 SectionConstraint::SectionConstraint(double acc_lin, double acc_ang, double vel_lin, double vel_ang)
 {
     acceleration_magnitude_linear_ = acc_lin;
@@ -9,4 +25,15 @@ SectionConstraint::SectionConstraint(double acc_lin, double acc_ang, double vel_
 
     velocity_magnitude_linear_ = vel_lin;
     velocity_magnitude_angular_ = vel_ang;
-}
\ No newline at end of file
+}
+
+SectionConstraint::SectionConstraint(double acc_lin, double acc_ang, double vel_lin, double vel_ang,
+                                     std::vector<double> acc_per_dof, std::vector<double> vel_per_dof)
+    : SectionConstraint(acc_lin, acc_ang, vel_lin, vel_ang)
+{
+    checkLimitsPerDoF(acc_per_dof, "acceleration");
+    checkLimitsPerDoF(vel_per_dof, "velocity");
+
+    acceleration_per_dof_ = std::move(acc_per_dof);
+    velocity_per_dof_ = std::move(vel_per_dof);
+}
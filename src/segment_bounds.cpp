@@ -0,0 +1,59 @@
+#include "sotg/segment_bounds.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+using namespace SOTG;
+
+SegmentBoundsTree::SegmentBoundsTree(size_t num_dof, std::vector<SegmentBounds>&& segments)
+    : num_dof_(num_dof)
+    , segments_(std::move(segments))
+{
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        if (segments_[i].box.getNumDoF() != num_dof_) {
+            throw std::runtime_error("SegmentBoundsTree: The bounds of segment " + std::to_string(i) + " span "
+                                     + std::to_string(segments_[i].box.getNumDoF()) + " instead of "
+                                     + std::to_string(num_dof_) + " DoF");
+        }
+        if (i > 0 && segments_[i].start_time < segments_[i - 1].start_time) {
+            throw std::runtime_error("SegmentBoundsTree: The segments have to be in order of their start time");
+        }
+    }
+
+    hierarchy_.build(segments_, num_dof_);
+}
+
+BoundingBox SegmentBoundsTree::getBoundingBox() const
+{
+    return hierarchy_.isEmpty() ? BoundingBox(num_dof_) : hierarchy_.getRoot().box;
+}
+
+size_t SegmentBoundsTree::findSegmentsInRegion(const BoundingBox& region, std::vector<size_t>& indices,
+                                               double start_time, double end_time) const
+{
+    if (hierarchy_.isEmpty() || end_time < start_time) {
+        return 0;
+    }
+    if (region.getNumDoF() != num_dof_) {
+        throw std::runtime_error("SegmentBoundsTree: The region spans " + std::to_string(region.getNumDoF())
+                                 + " DoF, but the segments " + std::to_string(num_dof_));
+    }
+
+    size_t num_found = 0;
+    auto intersects_region = [&](const BoundingBox& box) { return box.intersects(region); };
+    auto visit_leaf = [&](size_t first_segment, size_t end_segment) {
+        for (size_t i = first_segment; i < end_segment; ++i) {
+            const SegmentBounds& segment = segments_[i];
+            if (segment.end_time >= start_time && segment.start_time <= end_time
+                && intersects_region(segment.box)) {
+                indices.push_back(i);
+                ++num_found;
+            }
+        }
+    };
+    // The left child is visited first, so the segments are found in order of time
+    auto in_time_order = [](const BoundingBox&, const BoundingBox&) { return false; };
+    hierarchy_.traverse(start_time, end_time, intersects_region, visit_leaf, in_time_order);
+    return num_found;
+}
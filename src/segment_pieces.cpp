@@ -0,0 +1,222 @@
+#include "sotg/segment_pieces.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "sotg/utility_functions.hpp"
+
+using namespace SOTG;
+using namespace detail;
+
+namespace {
+// Newton steps that polish the closed form roots of the cubic
+constexpr int NUM_ROOT_POLISH_STEPS = 2;
+}  // namespace
+
+double calcParabolaDeviation(std::vector<double>& coefficients, size_t num_linear_dof, const Point& dir_AB,
+                             const Point& dir_BC, double vel_pre, double vel_post, double duration,
+                             const Point& corner);
+
+// The blend starts at the positions in front of coefficients and accelerates constantly from the pre to the post
+// blend velocity, fills in its velocity and acceleration
+double calcParabolaDeviation(std::vector<double>& coefficients, size_t num_linear_dof, const Point& dir_AB,
+                             const Point& dir_BC, double vel_pre, double vel_post, double duration,
+                             const Point& corner)
+{
+    double* pos = coefficients.data();
+    double* vel = pos + num_linear_dof;
+    double* acc = vel + num_linear_dof;
+    for (size_t i = 0; i < num_linear_dof; ++i) {
+        vel[i] = dir_AB[i] * vel_pre;
+        acc[i] = (dir_BC[i] * vel_post - dir_AB[i] * vel_pre) / duration;
+    }
+
+    double time = 0.0;
+    return std::sqrt(calcClosestApproach(pos, vel, acc, num_linear_dof, corner.asVector().data(), 0.0, duration,
+                                         time));
+}
+
+void detail::evaluateSegment(const Segment& segment, double time, const KinematicSolver& solver, Point& pos,
+                             Point& vel)
+{
+    const Section& section = dynamic_cast<const BlendSegment*>(&segment) != nullptr
+                                 ? segment.getPostBlendSection()
+                                 : segment.getSection();
+    double t_section = time - (section.getStartTime() - section.getTimeShift());
+    segment.calcPosAndVel(t_section, time - segment.getStartTime(), pos, vel, solver);
+}
+
+void detail::appendPieces(const Segment& segment, std::vector<ConstantAccelerationPiece>& pieces)
+{
+    if (utility::nearlyZero(segment.getDuration())) {
+        return;
+    }
+
+    double piece_start = segment.getStartTime();
+    if (dynamic_cast<const BlendSegment*>(&segment) == nullptr) {
+        const Section& section = segment.getSection();
+        double section_start = section.getStartTime() - section.getTimeShift();
+        for (const Phase& phase : section.getPhases()) {
+            double phase_end = section_start + phase.t_start + phase.duration;
+            if (phase_end > piece_start && phase_end < segment.getEndTime()) {
+                if (!utility::nearlyZero(phase_end - piece_start)) {
+                    pieces.push_back({ &segment, piece_start, phase_end });
+                }
+                piece_start = phase_end;
+            }
+        }
+    }
+    if (!utility::nearlyZero(segment.getEndTime() - piece_start)) {
+        pieces.push_back({ &segment, piece_start, segment.getEndTime() });
+    }
+}
+
+std::vector<ConstantAccelerationPiece>
+detail::splitIntoPieces(const std::pmr::list<std::shared_ptr<Segment>>& segments)
+{
+    std::vector<ConstantAccelerationPiece> pieces;
+    for (const std::shared_ptr<Segment>& segment : segments) {
+        appendPieces(*segment, pieces);
+    }
+    return pieces;
+}
+
+void detail::calcPieceCoefficients(const ConstantAccelerationPiece& piece, const KinematicSolver& solver,
+                                   size_t num_dof, double* pos, double* vel, double* acc)
+{
+    Point pos_start, vel_start, pos_end, vel_end;
+    evaluateSegment(*piece.segment, piece.start_time, solver, pos_start, vel_start);
+    evaluateSegment(*piece.segment, piece.end_time, solver, pos_end, vel_end);
+    double duration = piece.end_time - piece.start_time;
+    for (size_t i = 0; i < num_dof; ++i) {
+        pos[i] = pos_start[i];
+        vel[i] = vel_start[i];
+        acc[i] = (vel_end[i] - vel_start[i]) / duration;
+    }
+}
+
+size_t detail::getNumPositionDoF(const Section& section)
+{
+    int orientation_index = section.getStartPoint().getOrientationIndex();
+    return orientation_index == -1 ? section.getDifference().size() : static_cast<size_t>(orientation_index);
+}
+
+int detail::solveCubic(double c3, double c2, double c1, double c0, std::array<double, 3>& roots)
+{
+    double scale = std::abs(c2) + std::abs(c1) + std::abs(c0);
+    int num_roots = 0;
+    if (std::abs(c3) <= 1e-12 * scale) {
+        if (std::abs(c2) <= 1e-12 * (std::abs(c1) + std::abs(c0))) {
+            if (c1 != 0.0) {
+                roots[num_roots++] = -c0 / c1;
+            }
+            return num_roots;
+        }
+        double discriminant = c1 * c1 - 4.0 * c2 * c0;
+        if (discriminant < 0.0) {
+            return 0;
+        }
+        double sqrt_discriminant = std::sqrt(discriminant);
+        roots[num_roots++] = (-c1 + sqrt_discriminant) / (2.0 * c2);
+        roots[num_roots++] = (-c1 - sqrt_discriminant) / (2.0 * c2);
+        return num_roots;
+    }
+
+    // Depressed cubic x^3 + p x + q with t = x - b / 3
+    double b = c2 / c3;
+    double c = c1 / c3;
+    double d = c0 / c3;
+    double p = c - b * b / 3.0;
+    double q = 2.0 * b * b * b / 27.0 - b * c / 3.0 + d;
+    double discriminant = q * q / 4.0 + p * p * p / 27.0;
+    if (discriminant > 0.0) {
+        double sqrt_discriminant = std::sqrt(discriminant);
+        roots[num_roots++]
+            = std::cbrt(-q / 2.0 + sqrt_discriminant) + std::cbrt(-q / 2.0 - sqrt_discriminant) - b / 3.0;
+    } else if (p == 0.0) {
+        roots[num_roots++] = std::cbrt(-q) - b / 3.0;
+    } else {
+        double radius = 2.0 * std::sqrt(-p / 3.0);
+        double angle = std::acos(std::clamp(3.0 * q / (p * radius), -1.0, 1.0)) / 3.0;
+        for (int k = 0; k < 3; ++k) {
+            roots[num_roots++] = radius * std::cos(angle - 2.0 * M_PI * k / 3.0) - b / 3.0;
+        }
+    }
+
+    for (int i = 0; i < num_roots; ++i) {
+        for (int step = 0; step < NUM_ROOT_POLISH_STEPS; ++step) {
+            double t = roots[i];
+            double value = ((c3 * t + c2) * t + c1) * t + c0;
+            double slope = (3.0 * c3 * t + 2.0 * c2) * t + c1;
+            if (slope != 0.0) {
+                roots[i] = t - value / slope;
+            }
+        }
+    }
+    return num_roots;
+}
+
+double detail::calcClosestApproach(const double* pos, const double* vel, const double* acc, size_t num_dof,
+                                   const double* point, double t_begin, double t_end, double& time)
+{
+    // The squared distance |w + vel t + acc t^2 / 2|^2 is extremal where its derivative, a cubic, vanishes
+    double w_vel = 0.0, w_acc = 0.0, vel_vel = 0.0, vel_acc = 0.0, acc_acc = 0.0;
+    for (size_t i = 0; i < num_dof; ++i) {
+        double w = pos[i] - point[i];
+        w_vel += w * vel[i];
+        w_acc += w * acc[i];
+        vel_vel += vel[i] * vel[i];
+        vel_acc += vel[i] * acc[i];
+        acc_acc += acc[i] * acc[i];
+    }
+
+    std::array<double, 5> candidates{ t_begin, t_end };
+    std::array<double, 3> roots{};
+    int num_roots = solveCubic(0.5 * acc_acc, 1.5 * vel_acc, w_acc + vel_vel, w_vel, roots);
+    int num_candidates = 2;
+    for (int i = 0; i < num_roots; ++i) {
+        if (roots[i] > t_begin && roots[i] < t_end) {
+            candidates[num_candidates++] = roots[i];
+        }
+    }
+
+    double min_squared_distance = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < num_candidates; ++i) {
+        double t = candidates[i];
+        double squared_distance = 0.0;
+        for (size_t j = 0; j < num_dof; ++j) {
+            double difference = pos[j] + (vel[j] + 0.5 * acc[j] * t) * t - point[j];
+            squared_distance += difference * difference;
+        }
+        if (squared_distance < min_squared_distance) {
+            min_squared_distance = squared_distance;
+            time = t;
+        }
+    }
+    return min_squared_distance;
+}
+
+double detail::calcBlendDeviation(const BlendParameters& params, const Section& pre_section,
+                                  const Section& post_section)
+{
+    if (utility::nearlyZero(params.duration)) {
+        return 0.0;
+    }
+
+    // The blend starts pre_blend_distance before the corner, like ConstantAccelerationSolver::calcPreBlendParams
+    const Point& corner = post_section.getStartPoint();
+    const Point& A = pre_section.getStartPoint();
+    const Point& AB = pre_section.getDifference();
+    double length_AB = pre_section.getLength();
+    size_t num_linear_dof
+        = corner.getOrientationIndex() == -1 ? corner.size() : static_cast<size_t>(corner.getOrientationIndex());
+
+    std::vector<double> coefficients(3 * num_linear_dof);
+    for (size_t i = 0; i < num_linear_dof; ++i) {
+        coefficients[i] = A[i] + AB[i] * ((length_AB - params.pre_blend_distance) / length_AB);
+    }
+    return calcParabolaDeviation(coefficients, num_linear_dof, pre_section.getDirection(),
+                                 post_section.getDirection(), params.pre_velocity_magnitude,
+                                 params.post_velocity_magnitude, params.duration, corner);
+}
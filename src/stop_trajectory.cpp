@@ -0,0 +1,69 @@
+#include "sotg/stop_trajectory.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace SOTG;
+
+StopTrajectory::StopTrajectory(size_t num_dof, double start_time)
+    : num_dof_(num_dof)
+    , start_time_(start_time)
+{
+    if (num_dof_ > MAX_DOF) {
+        throw std::runtime_error("StopTrajectory: At most " + std::to_string(MAX_DOF) + " DoF are supported, but "
+                                 + std::to_string(num_dof_) + " where given");
+    }
+}
+
+void StopTrajectory::addPiece(double duration, const Values& pos, const Values& vel, const Values& acc)
+{
+    if (num_pieces_ == MAX_PIECES) {
+        throw std::runtime_error("StopTrajectory: At most " + std::to_string(MAX_PIECES) + " pieces are supported");
+    }
+
+    Piece& piece = pieces_[num_pieces_];
+    piece.duration = std::max(duration, 0.0);
+    piece.pos = pos;
+    piece.vel = vel;
+    piece.acc = acc;
+    ++num_pieces_;
+}
+
+double StopTrajectory::getDuration() const
+{
+    double duration = 0.0;
+    for (size_t i = 0; i < num_pieces_; ++i) {
+        duration += pieces_[i].duration;
+    }
+    return duration;
+}
+
+void StopTrajectory::calcPositionAndVelocity(double t, Values& pos, Values& vel) const
+{
+    pos.fill(0.0);
+    vel.fill(0.0);
+    if (num_pieces_ == 0) {
+        return;
+    }
+
+    // Find the piece t falls into, the last one is held at its end
+    size_t index = 0;
+    double t_piece = std::max(t, 0.0);
+    while (index + 1 < num_pieces_ && t_piece > pieces_[index].duration) {
+        t_piece -= pieces_[index].duration;
+        ++index;
+    }
+    const Piece& piece = pieces_[index];
+    t_piece = std::min(t_piece, piece.duration);
+
+    for (size_t i = 0; i < num_dof_; ++i) {
+        pos[i] = piece.pos[i] + piece.vel[i] * t_piece + 0.5 * piece.acc[i] * t_piece * t_piece;
+        vel[i] = piece.vel[i] + piece.acc[i] * t_piece;
+    }
+
+    // The deceleration ends at rest exactly, without rounding errors of the last velocity
+    if (index + 1 == num_pieces_ && t_piece >= piece.duration) {
+        vel.fill(0.0);
+    }
+}
@@ -0,0 +1,51 @@
+#include "sotg/tracing.hpp"
+
+#include <stdexcept>
+
+using namespace SOTG;
+
+ChromeTraceWriter::ChromeTraceWriter(const std::string& file_name)
+    : file_(file_name)
+    , start_(std::chrono::steady_clock::now())
+{
+    if (!file_.is_open()) {
+        throw std::runtime_error("ChromeTraceWriter: Could not open \"" + file_name + "\"");
+    }
+    file_ << "[";
+}
+
+ChromeTraceWriter::~ChromeTraceWriter()
+{
+    file_ << "\n]\n";
+}
+
+void ChromeTraceWriter::writeEvent(const char* name, char phase)
+{
+    std::chrono::duration<double, std::micro> timestamp = std::chrono::steady_clock::now() - start_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Small consecutive thread ids keep the timeline readable
+    size_t thread_id = thread_ids_.emplace(std::this_thread::get_id(), thread_ids_.size()).first->second;
+
+    file_ << (is_first_event_ ? "\n" : ",\n");
+    file_ << "{\"name\":\"" << name << "\",\"cat\":\"sotg\",\"ph\":\"" << phase << "\",\"ts\":" << std::fixed
+          << timestamp.count() << ",\"pid\":1,\"tid\":" << thread_id << "}";
+    is_first_event_ = false;
+}
+
+void ChromeTraceWriter::beginZone(const char* name)
+{
+    writeEvent(name, 'B');
+}
+
+void ChromeTraceWriter::endZone(const char* name)
+{
+    writeEvent(name, 'E');
+}
+
+void ChromeTraceWriter::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.flush();
+}
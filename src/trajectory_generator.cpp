@@ -1,54 +1,468 @@
 #include "sotg/trajectory_generator.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <thread>
+#include <utility>
+
+#include "sotg/segment_pieces.hpp"
 
 using namespace SOTG;
 using namespace detail;
 
+namespace {
+// The end of an exported piece is compared this fraction of its duration before it
+constexpr double EXPORT_END_FRACTION = 1e-9;
+}  // namespace
+
+TrajectoryPhase toTrajectoryPhase(PhaseType type);
+
+// The solver phases are internal, events name them with the public enum
+TrajectoryPhase toTrajectoryPhase(PhaseType type)
+{
+    switch (type) {
+    case ConstantAcceleration:
+        return ACCELERATING;
+    case ConstantVelocity:
+        return COASTING;
+    case ConstantDeacceleration:
+    default:
+        return DECELERATING;
+    }
+}
+
 TrajectoryGenerator::TrajectoryGenerator()
     : default_logger_(new Logger())
     , logger_(*default_logger_)
-    , kinematic_solver_(new detail::ConstantAccelerationSolver(logger_))
+    , kinematic_solver_(new detail::ConstantAccelerationSolver<>(logger_))
 {
-    path_manager_
-        = std::unique_ptr<detail::PathManager>(new detail::PathManager(kinematic_solver_, debug_info_vec_));
+    path_manager_ = std::unique_ptr<detail::PathManager>(
+        new detail::PathManager(kinematic_solver_, instrumentation_));
 }
 
 TrajectoryGenerator::TrajectoryGenerator(const Logger& logger)
     : logger_(logger)
-    , kinematic_solver_(new detail::ConstantAccelerationSolver(logger_))
+    , kinematic_solver_(new detail::ConstantAccelerationSolver<>(logger_))
+{
+    path_manager_ = std::unique_ptr<detail::PathManager>(
+        new detail::PathManager(kinematic_solver_, instrumentation_));
+}
+
+void TrajectoryGenerator::resetPath(const Path& path, const std::vector<SectionConstraint>& section_constraints,
+                                    const std::vector<SegmentConstraint>& segment_constraints)
+{
+    path_manager_->resetPath(Path(path), std::vector<SectionConstraint>(section_constraints),
+                             std::vector<SegmentConstraint>(segment_constraints));
+}
+
+void TrajectoryGenerator::resetPath(Path&& path, std::vector<SectionConstraint>&& section_constraints,
+                                    std::vector<SegmentConstraint>&& segment_constraints)
+{
+    path_manager_->resetPath(std::move(path), std::move(section_constraints), std::move(segment_constraints));
+}
+
+PreprocessingReport TrajectoryGenerator::resetPath(Path path, std::vector<SectionConstraint> section_constraints,
+                                                   std::vector<SegmentConstraint> segment_constraints,
+                                                   const PreprocessingOptions& options)
+{
+    double duration_before = 0.0;
+    if (options.measure_cycle_time_gain) {
+        // The debug info of the reference run is replaced by the final planning below
+        Path reference_path = path;
+        std::vector<SectionConstraint> reference_section_constraints = section_constraints;
+        std::vector<SegmentConstraint> reference_segment_constraints = segment_constraints;
+        path_manager_->resetPath(std::move(reference_path), std::move(reference_section_constraints),
+                                 std::move(reference_segment_constraints));
+        duration_before = getDuration();
+    }
+
+    PreprocessingReport report = path.preprocess(section_constraints, segment_constraints, options);
+
+    logger_.logRecord({ PATH_PREPROCESSED, Logger::INFO, -1, -1,
+                        { static_cast<double>(report.getNumRemovedWaypoints()),
+                          static_cast<double>(report.num_waypoints_before) } });
+
+    path_manager_->resetPath(std::move(path), std::move(section_constraints), std::move(segment_constraints));
+
+    if (options.measure_cycle_time_gain) {
+        report.duration_before = duration_before;
+        report.duration_after = getDuration();
+    }
+
+    return report;
+}
+
+void TrajectoryGenerator::appendPath(Path&& path, std::vector<SectionConstraint>&& section_constraints,
+                                     std::vector<SegmentConstraint>&& segment_constraints, double current_time)
+{
+    path_manager_->appendPath(std::move(path), std::move(section_constraints), std::move(segment_constraints),
+                              current_time);
+}
+
+void TrajectoryGenerator::splice(TrajectoryGenerator& other, const SegmentConstraint& junction_constraint)
+{
+    path_manager_->splice(*other.path_manager_, junction_constraint);
+}
+
+void TrajectoryGenerator::pushWaypoint(Point point, const SectionConstraint& section_constraint,
+                                       const SegmentConstraint& segment_constraint)
+{
+    path_manager_->pushWaypoint(std::move(point), section_constraint, segment_constraint);
+}
+
+void TrajectoryGenerator::advanceSlidingWindow(double current_time, double planning_horizon)
+{
+    path_manager_->advanceWindow(current_time, planning_horizon);
+}
+
+void TrajectoryGenerator::setMemoryResource(std::pmr::memory_resource* resource)
+{
+    // Containers can not change their resource, the old path is dropped together with its path manager
+    double blend_look_ahead = path_manager_->getBlendLookAhead();
+    double blend_max_deviation = path_manager_->getBlendMaxDeviation();
+    path_manager_.reset();
+    kinematic_solver_->setMemoryResource(resource);
+    path_manager_ = std::unique_ptr<detail::PathManager>(
+        new detail::PathManager(kinematic_solver_, instrumentation_, resource));
+    path_manager_->setTracer(tracer_);
+    path_manager_->setBlendLookAhead(blend_look_ahead);
+    path_manager_->setBlendMaxDeviation(blend_max_deviation);
+}
+
+void TrajectoryGenerator::clearPath()
+{
+    path_manager_->clear();
+}
+
+void TrajectoryGenerator::enableLazyBlending(double look_ahead_time)
+{
+    if (look_ahead_time < 0.0) {
+        throw std::runtime_error("TrajectoryGenerator: The look ahead time for lazy blending must not be negative");
+    }
+    path_manager_->setBlendLookAhead(look_ahead_time);
+}
+
+void TrajectoryGenerator::disableLazyBlending()
+{
+    path_manager_->setBlendLookAhead(-1.0);
+}
+
+void TrajectoryGenerator::enableBlendOptimization(double max_deviation)
+{
+    if (max_deviation < 0.0) {
+        throw std::runtime_error("TrajectoryGenerator: The maximum deviation of blends must not be negative");
+    }
+    path_manager_->setBlendMaxDeviation(max_deviation);
+}
+
+void TrajectoryGenerator::disableBlendOptimization()
+{
+    path_manager_->setBlendMaxDeviation(-1.0);
+}
+
+void TrajectoryGenerator::setTracer(Tracer* tracer)
+{
+    tracer_ = tracer;
+    kinematic_solver_->setTracer(tracer);
+    path_manager_->setTracer(tracer);
+}
+
+void TrajectoryGenerator::setOrientationInterpolation(OrientationInterpolation type)
+{
+    kinematic_solver_->setOrientationInterpolation(type);
+}
+
+void TrajectoryGenerator::setBlendFallback(BlendFallback fallback)
+{
+    kinematic_solver_->setBlendFallback(fallback);
+}
+
+BlendFallbackReport TrajectoryGenerator::getBlendFallbackReport()
 {
-    path_manager_
-        = std::unique_ptr<detail::PathManager>(new detail::PathManager(kinematic_solver_, debug_info_vec_));
+    path_manager_->completeBlends();
+
+    BlendFallbackReport report;
+    for (const std::shared_ptr<Segment>& segment : path_manager_->getSegments()) {
+        const BlendSegment* blend_segment = dynamic_cast<const BlendSegment*>(segment.get());
+        if (blend_segment == nullptr) {
+            continue;
+        }
+        ++report.num_blends;
+        if (blend_segment->getFallbackResult() == EXTENDED_BLEND) {
+            double distance_increase = blend_segment->getBlendDistanceIncrease();
+            ++report.num_extended;
+            report.total_distance_increase += distance_increase;
+            report.max_distance_increase = std::max(report.max_distance_increase, distance_increase);
+        } else if (blend_segment->getFallbackResult() == STOPPED) {
+            ++report.num_stopped;
+        }
+    }
+    return report;
 }
 
-void TrajectoryGenerator::resetPath(Path path, std::vector<SectionConstraint> section_constraints,
-                                    std::vector<SegmentConstraint> segment_constraints)
+StopTrajectory TrajectoryGenerator::planStop(double time)
 {
-    path_manager_->resetPath(path, section_constraints, segment_constraints);
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::planStop");
+
+    const Segment& segment = path_manager_->getSegmentAtTime(time);
+    const Section& section = dynamic_cast<const BlendSegment*>(&segment) != nullptr
+                                 ? segment.getPostBlendSection()
+                                 : segment.getSection();
+
+    double t_segment = time - segment.getStartTime();
+    double t_section = time - (section.getStartTime() - section.getTimeShift());
+
+    StopTrajectory stop(section.getDifference().size(), time);
+    kinematic_solver_->calcStop(t_section, t_segment, segment, stop);
+    return stop;
 }
 
 double TrajectoryGenerator::getDuration()
 {
-    double total_time = 0.0;
-    for (std::shared_ptr<Segment> segment : path_manager_->getSegments()) {
-        total_time += segment->getDuration();
+    // The time shifts of all blends are needed for the duration
+    path_manager_->completeBlends();
+
+    // Segments are contiguous, appended paths may start later than at zero
+    return path_manager_->getEndTime();
+}
+
+DistanceQuery TrajectoryGenerator::buildDistanceQuery()
+{
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::buildDistanceQuery");
+
+    // The time shifts of all blends are needed for the piece times
+    path_manager_->completeBlends();
+    const std::pmr::list<std::shared_ptr<Segment>>& segments = path_manager_->getSegments();
+    if (segments.empty()) {
+        return DistanceQuery();
+    }
+
+    size_t num_position_dof = getNumPositionDoF(path_manager_->getSections().front());
+
+    DistanceQuery query(num_position_dof);
+    std::vector<double> pos(num_position_dof), vel(num_position_dof), acc(num_position_dof);
+    for (const ConstantAccelerationPiece& piece : splitIntoPieces(segments)) {
+        calcPieceCoefficients(piece, *kinematic_solver_, num_position_dof, pos.data(), vel.data(), acc.data());
+        query.addPiece(piece.start_time, piece.end_time, pos.data(), vel.data(), acc.data());
+    }
+    query.build();
+    return query;
+}
+
+const SegmentBoundsTree& TrajectoryGenerator::getSegmentBounds()
+{
+    path_manager_->completeBlends();
+    return path_manager_->getSegmentBounds();
+}
+
+size_t TrajectoryGenerator::sampleTrajectory(double sample_period, std::vector<double>& positions,
+                                             std::vector<double>& velocities, size_t num_threads)
+{
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::sampleTrajectory");
+
+    if (!(sample_period > 0.0)) {
+        throw std::runtime_error("TrajectoryGenerator: The sample period must be positive");
     }
-    return total_time;
+
+    double duration = getDuration();
+    const std::pmr::list<std::shared_ptr<Segment>>& segments = path_manager_->getSegments();
+    if (segments.empty()) {
+        positions.clear();
+        velocities.clear();
+        return 0;
+    }
+    size_t num_dof = path_manager_->getSections().front().getDifference().size();
+    size_t num_samples = static_cast<size_t>(std::floor(duration / sample_period)) + 1;
+
+    // Segments with the first sample that falls into each of them, samples at a boundary belong to the later one
+    std::vector<const Segment*> sampled_segments;
+    std::vector<size_t> first_samples;
+    for (const std::shared_ptr<Segment>& segment_ptr : segments) {
+        if (utility::nearlyZero(segment_ptr->getDuration())) {
+            continue;
+        }
+        double start_time = segment_ptr->getStartTime();
+        size_t first_sample = static_cast<size_t>(std::max(std::ceil(start_time / sample_period), 0.0));
+        while (first_sample > 0 && static_cast<double>(first_sample - 1) * sample_period >= start_time) {
+            --first_sample;
+        }
+        while (static_cast<double>(first_sample) * sample_period < start_time) {
+            ++first_sample;
+        }
+        sampled_segments.push_back(segment_ptr.get());
+        first_samples.push_back(sampled_segments.size() == 1 ? 0 : first_sample);
+    }
+
+    positions.resize(num_samples * num_dof);
+    velocities.resize(num_samples * num_dof);
+
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    num_threads = std::min(num_threads, num_samples);
+
+    // Every worker writes its own range of the outputs, errors are passed on to the calling thread
+    std::vector<std::exception_ptr> errors(num_threads);
+    auto sample_range = [&](size_t worker, size_t begin, size_t end) {
+        try {
+            size_t index = static_cast<size_t>(std::upper_bound(first_samples.begin(), first_samples.end(), begin)
+                                               - first_samples.begin())
+                           - 1;
+            // Segments overwrite pos and vel in place, their storage is allocated once per worker
+            Point pos, vel;
+            for (size_t sample = begin; sample < end; ++sample) {
+                while (index + 1 < first_samples.size() && first_samples[index + 1] <= sample) {
+                    ++index;
+                }
+                double time = std::min(static_cast<double>(sample) * sample_period, duration);
+                evaluateSegment(*sampled_segments[index], time, *kinematic_solver_, pos, vel);
+                for (size_t i = 0; i < num_dof; ++i) {
+                    positions[sample * num_dof + i] = pos[i];
+                    velocities[sample * num_dof + i] = vel[i];
+                }
+            }
+        } catch (...) {
+            errors[worker] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_threads - 1);
+    for (size_t worker = 1; worker < num_threads; ++worker) {
+        workers.emplace_back(sample_range, worker, num_samples * worker / num_threads,
+                             num_samples * (worker + 1) / num_threads);
+    }
+    sample_range(0, 0, num_samples / num_threads);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return num_samples;
+}
+
+template <typename Scalar>
+PolynomialTrajectory<Scalar> TrajectoryGenerator::exportPolynomial()
+{
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::exportPolynomial");
+
+    double duration = getDuration();
+    const std::pmr::list<std::shared_ptr<Segment>>& segments = path_manager_->getSegments();
+    if (segments.empty()) {
+        return PolynomialTrajectory<Scalar>();
+    }
+
+    const Section& first_section = path_manager_->getSections().front();
+    size_t num_dof = first_section.getDifference().size();
+    if (kinematic_solver_->getOrientationInterpolation() == QUATERNION_SLERP
+        && first_section.getStartPoint().getOrientationIndex() != -1) {
+        throw std::runtime_error("TrajectoryGenerator: Slerp orientations are no polynomials, the export needs "
+                                 "component wise orientation interpolation");
+    }
+
+    std::vector<ConstantAccelerationPiece> pieces = splitIntoPieces(segments);
+
+    PolynomialTrajectory<Scalar> trajectory(num_dof);
+    std::vector<double> pos(num_dof), vel(num_dof), acc(num_dof);
+    for (const ConstantAccelerationPiece& piece : pieces) {
+        calcPieceCoefficients(piece, *kinematic_solver_, num_dof, pos.data(), vel.data(), acc.data());
+        trajectory.addPiece(piece.start_time, pos.data(), vel.data(), acc.data());
+    }
+    trajectory.setEndTime(duration);
+
+    // Error bounds against the double evaluation. The end of a piece is sampled just before the next one starts.
+    std::vector<Scalar> exported_pos(num_dof), exported_vel(num_dof);
+    for (const ConstantAccelerationPiece& piece : pieces) {
+        for (double fraction : { 0.0, 0.5, 1.0 - EXPORT_END_FRACTION }) {
+            double time = piece.start_time + fraction * (piece.end_time - piece.start_time);
+            Point pos_reference, vel_reference;
+            evaluateSegment(*piece.segment, time, *kinematic_solver_, pos_reference, vel_reference);
+            trajectory.calcPositionAndVelocity(time, exported_pos.data(), exported_vel.data());
+
+            double position_error = 0.0, velocity_error = 0.0;
+            for (size_t j = 0; j < num_dof; ++j) {
+                position_error = std::max(position_error, std::abs(exported_pos[j] - pos_reference[j]));
+                velocity_error = std::max(velocity_error, std::abs(exported_vel[j] - vel_reference[j]));
+            }
+            trajectory.updateErrorBounds(position_error, velocity_error);
+        }
+    }
+
+    return trajectory;
+}
+
+template PolynomialTrajectory<float> TrajectoryGenerator::exportPolynomial<float>();
+template PolynomialTrajectory<double> TrajectoryGenerator::exportPolynomial<double>();
+
+EventTimeline TrajectoryGenerator::buildEventTimeline()
+{
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::buildEventTimeline");
+
+    // The time shifts of all blends are needed for the event times
+    path_manager_->completeBlends();
+
+    std::vector<TrajectoryEvent> events;
+
+    // A waypoint counts as passed once the section that ends in it is over, like in getNumPassedWaypoints
+    for (const Section& section : path_manager_->getSections()) {
+        double t_end = section.getStartTime() + section.getDuration() - section.getTimeShift();
+        events.push_back({ WAYPOINT_REACHED, t_end, section.getEndWaypointID(), section.getID(), DECELERATING });
+    }
+
+    for (const std::shared_ptr<Segment>& segment_ptr : path_manager_->getSegments()) {
+        const Segment& segment = *segment_ptr;
+        if (utility::nearlyZero(segment.getDuration())) {
+            continue;
+        }
+
+        if (dynamic_cast<const BlendSegment*>(&segment) != nullptr) {
+            const Section& pre_section = segment.getPreBlendSection();
+            events.push_back({ BLEND_START, segment.getStartTime(), pre_section.getEndWaypointID(),
+                               pre_section.getID(), ACCELERATING });
+            events.push_back({ BLEND_END, segment.getEndTime(), pre_section.getEndWaypointID(), pre_section.getID(),
+                               ACCELERATING });
+            continue;
+        }
+
+        // Phase boundaries that fall into a blend are no change of the actual motion
+        const Section& section = segment.getSection();
+        double section_start = section.getStartTime() - section.getTimeShift();
+        for (const Phase& phase : section.getPhases()) {
+            double phase_start = section_start + phase.t_start;
+            if (!utility::nearlyZero(phase.duration) && phase_start > segment.getStartTime()
+                && phase_start < segment.getEndTime()) {
+                events.push_back({ PHASE_CHANGE, phase_start, section.getEndWaypointID(), section.getID(),
+                                   toTrajectoryPhase(phase.type) });
+            }
+        }
+    }
+
+    return EventTimeline(std::move(events));
 }
 
 int SOTG::TrajectoryGenerator::getNumPassedWaypoints(double tick)
 {
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::getNumPassedWaypoints");
+
     const Section& section = path_manager_->getSectionAtTime(tick);
-    const Point& section_start_point = section.getStartPoint();
 
-    return section_start_point.getID();
+    return section.getStartWaypointID();
 
 }
 void TrajectoryGenerator::calcPositionAndVelocity(double time, Point &pos, Point &vel, int &id,
                                                   bool disable_blending)
 {
+    SOTG_INSTRUMENT_SCOPE(instrumentation_, EVALUATION);
+    SOTG_TRACE_ZONE(tracer_, "TrajectoryGenerator::calcPositionAndVelocity");
+
     if (disable_blending) {
         const Section& section = path_manager_->getSectionAtTime(time);
 
@@ -69,4 +483,21 @@ void TrajectoryGenerator::calcPositionAndVelocity(double time, Point &pos, Point
 
         id = segment.getID();
     }
-}
\ No newline at end of file
+}
+std::vector<std::map<std::string, double>>& TrajectoryGenerator::getDebugInfo()
+{
+    debug_info_vec_.clear();
+    for (const std::shared_ptr<Segment>& segment : path_manager_->getSegments()) {
+        const BlendSegment* blend_segment = dynamic_cast<const BlendSegment*>(segment.get());
+        if (blend_segment != nullptr) {
+            debug_info_vec_.push_back({ { "pre_blend_dist", blend_segment->getPreBlendDistance() },
+                                        { "post_blend_dist", blend_segment->getPostBlendDistance() },
+                                        { "pre_blend_vel", blend_segment->getPreBlendVelocityMagnitude() },
+                                        { "post_blend_vel", blend_segment->getPostBlendVelocityMagnitude() },
+                                        { "requested_blend_dist", blend_segment->getRequestedBlendDistance() },
+                                        { "blend_fallback",
+                                          static_cast<double>(blend_segment->getFallbackResult()) } });
+        }
+    }
+    return debug_info_vec_;
+}
@@ -0,0 +1,130 @@
+#include "sotg/waypoint_reader.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace SOTG;
+
+namespace {
+const size_t num_constraint_columns = 5;
+}
+
+WaypointReader::WaypointReader(const std::string& file_name, Format format, size_t num_values,
+                               int orientation_index)
+    : file_name_(file_name)
+    , format_(format)
+    , num_values_(num_values)
+    , orientation_index_(orientation_index)
+    , row_(num_values + num_constraint_columns)
+{
+    if (format_ == BINARY) {
+        file_.open(file_name, std::ios::in | std::ios::binary);
+    } else {
+        file_.open(file_name, std::ios::in);
+    }
+
+    if (!file_.is_open()) {
+        throw std::runtime_error("WaypointReader: Could not open \"" + file_name + "\"");
+    }
+}
+
+bool WaypointReader::readChunk(size_t max_waypoints, Path& path, std::vector<SectionConstraint>& section_constraints,
+                               std::vector<SegmentConstraint>& segment_constraints)
+{
+    bool is_first_chunk = num_read_rows_ == 0;
+    size_t num_rows = is_first_chunk ? std::max<size_t>(max_waypoints, 2) : std::max<size_t>(max_waypoints, 1);
+
+    values_.clear();
+    section_constraints.clear();
+    segment_constraints.clear();
+    values_.reserve(num_rows * num_values_);
+    section_constraints.reserve(num_rows);
+    segment_constraints.reserve(num_rows);
+
+    size_t num_chunk_rows = 0;
+    while (num_chunk_rows < num_rows && readRow()) {
+        values_.insert(values_.end(), row_.begin(), row_.begin() + num_values_);
+
+        const double* constraint = row_.data() + num_values_;
+        if (num_read_rows_ > 0) {
+            section_constraints.emplace_back(constraint[0], constraint[1], constraint[2], constraint[3]);
+            // The blend distance of the previous row belongs to the corner this section starts in
+            segment_constraints.emplace_back(pending_blend_distance_);
+        }
+        pending_blend_distance_ = constraint[4];
+
+        ++num_chunk_rows;
+        ++num_read_rows_;
+    }
+
+    // The first waypoint of a path has no corner, the previous one is only known once the next chunk arrives
+    if (is_first_chunk && !segment_constraints.empty()) {
+        segment_constraints.erase(segment_constraints.begin());
+    }
+
+    if (num_chunk_rows == 0 || (is_first_chunk && num_chunk_rows < 2)) {
+        return false;
+    }
+
+    path = Path::fromMatrix(values_.data(), num_chunk_rows, num_values_, orientation_index_);
+
+    return true;
+}
+
+bool WaypointReader::readRow()
+{
+    if (format_ == BINARY) {
+        return readBinaryRow();
+    } else {
+        return readCSVRow();
+    }
+}
+
+bool WaypointReader::readBinaryRow()
+{
+    std::streamsize row_size = row_.size() * sizeof(double);
+    file_.read(reinterpret_cast<char*>(row_.data()), row_size);
+
+    if (file_.gcount() == 0) {
+        return false;
+    }
+    if (file_.gcount() != row_size) {
+        throw std::runtime_error("WaypointReader: \"" + file_name_ + "\" ends within row "
+                                 + std::to_string(num_read_rows_ + 1));
+    }
+
+    return true;
+}
+
+bool WaypointReader::readCSVRow()
+{
+    while (std::getline(file_, line_)) {
+        ++line_number_;
+
+        size_t first_char = line_.find_first_not_of(" \t\r");
+        if (first_char == std::string::npos || line_[first_char] == '#') {
+            continue;
+        }
+
+        const char* it = line_.c_str();
+        for (size_t i = 0; i < row_.size(); ++i) {
+            char* value_end;
+            row_[i] = std::strtod(it, &value_end);
+            if (value_end == it) {
+                throw std::runtime_error("WaypointReader: Line " + std::to_string(line_number_) + " of \""
+                                         + file_name_ + "\" has " + std::to_string(i) + " values, but "
+                                         + std::to_string(row_.size()) + " are expected");
+            }
+
+            it = value_end;
+            while (*it == ' ' || *it == '\t' || *it == ',') {
+                ++it;
+            }
+        }
+
+        return true;
+    }
+
+    return false;
+}
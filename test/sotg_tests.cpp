@@ -0,0 +1,733 @@
+// Randomized checks of planned trajectories, every case plans paths of random waypoints and limits and requires
+// checkTrajectory to pass. Returns non-zero if any check fails.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sotg/sotg.hpp"
+#include "trajectory_check.hpp"
+
+using namespace SOTG;
+
+namespace {
+
+// Warnings of the planner are expected for random limits
+class QuietLogger : public Logger {
+public:
+    void log(const std::string&, MsgType) const override {}
+};
+
+struct TestCase {
+    std::string name;
+    bool fixed_dof = false;
+    bool lazy_blending = false;
+    bool per_dof_limits = false;
+    bool slerp = false;
+    bool blend_optimization = false;
+};
+
+constexpr int NUM_SEEDS = 2;
+constexpr int NUM_WAYPOINTS = 10;
+constexpr double BLEND_DISTANCE = 0.1;
+constexpr double MAX_BLEND_DEVIATION = 0.02;
+constexpr double LAZY_LOOK_AHEAD = 0.5;
+constexpr int NUM_REGRESSION_SEEDS = 10;
+constexpr double SAMPLE_PERIOD = 5e-3;
+constexpr int NUM_STOPS = 7;
+// Phase changes are checked this long after they begin, events are advanced with ticks of EVENT_TICK
+constexpr double EVENT_OFFSET = 1e-4;
+constexpr double EVENT_TICK = 1e-2;
+constexpr int NUM_QUERIES = 8;
+constexpr size_t NUM_QUERY_POINTS = 3;
+// Brute force references scan the positions with this period, they miss the exact approach by up to the error
+constexpr double QUERY_SCAN_PERIOD = 1e-4;
+constexpr double MAX_QUERY_SCAN_ERROR = 1e-3;
+constexpr size_t RING_BUFFER_CAPACITY = 8;
+
+// Generous enough for unoptimized builds on a loaded machine, a regression that scans the path per evaluation
+// exceeds it
+constexpr uint64_t MAX_EVALUATION_LATENCY_NS = 200000;
+
+int num_failures = 0;
+
+void expect(bool condition, const std::string& description);
+Path generatePath(std::mt19937& rng);
+std::vector<SectionConstraint> generateSectionConstraints(std::mt19937& rng, bool per_dof_limits);
+PlannedPath planPath(TrajectoryGenerator& generator, const TestCase& test_case, bool lazy_blending,
+                     std::mt19937 rng);
+TrajectoryCheckOptions getCheckOptions();
+void runCase(const TestCase& test_case, int seed);
+void testLatencyGuard();
+void testIndependentLinearAndAngularLimits();
+double calcDistanceToPath(const Path& path, const std::vector<double>& position, size_t num_dof);
+void testStop();
+void testSplice();
+template <typename Scalar>
+void testPolynomialExport(double max_error_bound, const std::string& name);
+void testEventTimeline();
+void testParallelSampling();
+void testDistanceQuery();
+void testSegmentBounds();
+void testRingBufferLogger();
+
+void expect(bool condition, const std::string& description)
+{
+    if (!condition) {
+        std::printf("FAILED: %s\n", description.c_str());
+        ++num_failures;
+    }
+}
+
+// Six DoF per waypoint, three positions and three angles
+Path generatePath(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> position(-1.0, 1.0);
+    std::uniform_real_distribution<double> angle(-0.5, 0.5);
+    Path path;
+    for (int i = 0; i < NUM_WAYPOINTS; ++i) {
+        Eigen::VectorXd location(3);
+        Eigen::VectorXd orientation(3);
+        location << position(rng), position(rng), position(rng);
+        orientation << angle(rng), angle(rng), angle(rng);
+        path.addPoint(std::vector<Eigen::VectorXd>{ location, orientation });
+    }
+    return path;
+}
+
+std::vector<SectionConstraint> generateSectionConstraints(std::mt19937& rng, bool per_dof_limits)
+{
+    std::uniform_real_distribution<double> magnitude(0.2, 3.0);
+    std::uniform_real_distribution<double> per_dof(0.1, 2.0);
+    std::vector<SectionConstraint> constraints;
+    for (int i = 0; i < NUM_WAYPOINTS - 1; ++i) {
+        double acc_lin = magnitude(rng);
+        double acc_ang = magnitude(rng);
+        double vel_lin = magnitude(rng);
+        double vel_ang = magnitude(rng);
+        if (!per_dof_limits) {
+            constraints.emplace_back(acc_lin, acc_ang, vel_lin, vel_ang);
+            continue;
+        }
+        std::vector<double> acc_per_dof(6);
+        std::vector<double> vel_per_dof(6);
+        for (size_t dof = 0; dof < 6; ++dof) {
+            acc_per_dof[dof] = per_dof(rng);
+            vel_per_dof[dof] = per_dof(rng);
+        }
+        constraints.emplace_back(acc_lin, acc_ang, vel_lin, vel_ang, acc_per_dof, vel_per_dof);
+    }
+    return constraints;
+}
+
+// The generator is configured before the path is planned, rng is copied so eager and lazy blending plan the same
+// path. Returns the input of the planned path for the checks.
+PlannedPath planPath(TrajectoryGenerator& generator, const TestCase& test_case, bool lazy_blending,
+                     std::mt19937 rng)
+{
+    PlannedPath planned;
+    generator.setBlendFallback(EXTEND_BLEND_DISTANCE);
+    if (test_case.slerp) {
+        generator.setOrientationInterpolation(QUATERNION_SLERP);
+        planned.slerp = true;
+    }
+    if (lazy_blending) {
+        generator.enableLazyBlending(LAZY_LOOK_AHEAD);
+    }
+    if (test_case.blend_optimization) {
+        generator.enableBlendOptimization(MAX_BLEND_DEVIATION);
+        planned.max_blend_deviation = MAX_BLEND_DEVIATION;
+    }
+
+    planned.path = generatePath(rng);
+    planned.section_constraints = generateSectionConstraints(rng, test_case.per_dof_limits);
+    std::vector<SegmentConstraint> segment_constraints(NUM_WAYPOINTS - 2, SegmentConstraint(BLEND_DISTANCE));
+    generator.resetPath(planned.path, planned.section_constraints, segment_constraints);
+    return planned;
+}
+
+TrajectoryCheckOptions getCheckOptions()
+{
+    TrajectoryCheckOptions options;
+    options.sample_period = SAMPLE_PERIOD;
+    options.max_evaluation_latency_ns = MAX_EVALUATION_LATENCY_NS;
+    return options;
+}
+
+void runCase(const TestCase& test_case, int seed)
+{
+    std::string name = test_case.name + " seed " + std::to_string(seed);
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+    QuietLogger logger;
+
+    TrajectoryGenerator eager = test_case.fixed_dof ? TrajectoryGenerator(FixedDoF<6>(), logger)
+                                                    : TrajectoryGenerator(logger);
+    PlannedPath planned = planPath(eager, test_case, false, rng);
+    TrajectoryGenerator lazy = test_case.fixed_dof ? TrajectoryGenerator(FixedDoF<6>(), logger)
+                                                   : TrajectoryGenerator(logger);
+    planPath(lazy, test_case, true, rng);
+    TrajectoryGenerator& checked = test_case.lazy_blending ? lazy : eager;
+    TrajectoryGenerator& reference = test_case.lazy_blending ? eager : lazy;
+
+    TrajectoryCheckOptions options = getCheckOptions();
+    TrajectoryCheckReport report = checkTrajectory(checked, planned, options);
+    expect(report.num_samples > 0, name + ": no samples");
+    expect(report.isContinuous(options), name + ": not continuous, position jump "
+                                             + std::to_string(report.max_position_jump) + ", velocity jump "
+                                             + std::to_string(report.max_velocity_jump));
+    expect(report.isWithinLimits(options), name + ": limits exceeded, velocity ratio "
+                                               + std::to_string(report.max_velocity_ratio) + ", acceleration ratio "
+                                               + std::to_string(report.max_acceleration_ratio)
+                                               + ", blend deviation ratio "
+                                               + std::to_string(report.max_blend_deviation_ratio));
+    expect(report.isConsistent(options), name + ": differs from the dense reference integral by "
+                                             + std::to_string(report.max_integration_error));
+    expect(report.isFastEnough(options),
+           name + ": latency quantile "
+               + std::to_string(report.evaluation_latency.getQuantileUpperBoundNs(options.latency_quantile))
+               + " ns");
+    expect(report.isValid(options), name + ": not valid");
+
+    // Eager and lazy blending plan the same blends
+    expect(std::abs(checked.getDuration() - reference.getDuration()) <= 1e-9,
+           name + ": eager and lazy blending differ in duration");
+    std::vector<double> checked_positions, checked_velocities, reference_positions, reference_velocities;
+    checked.sampleTrajectory(options.sample_period, checked_positions, checked_velocities, 1);
+    reference.sampleTrajectory(options.sample_period, reference_positions, reference_velocities, 1);
+    double max_difference = 0.0;
+    if (checked_positions.size() == reference_positions.size()) {
+        for (size_t i = 0; i < checked_positions.size(); ++i) {
+            max_difference = std::max(max_difference, std::abs(checked_positions[i] - reference_positions[i]));
+            max_difference = std::max(max_difference, std::abs(checked_velocities[i] - reference_velocities[i]));
+        }
+    } else {
+        max_difference = std::numeric_limits<double>::infinity();
+    }
+    expect(max_difference <= 1e-9,
+           name + ": eager and lazy blending differ by " + std::to_string(max_difference));
+}
+
+// The guard has to reject a latency bound that no evaluation can keep
+void testLatencyGuard()
+{
+    std::mt19937 rng(1);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    PlannedPath planned = planPath(generator, TestCase{ "latency guard" }, false, rng);
+
+    TrajectoryCheckOptions options = getCheckOptions();
+    options.max_evaluation_latency_ns = 1;
+    TrajectoryCheckReport report = checkTrajectory(generator, planned, options);
+    expect(!report.isFastEnough(options), "latency guard: a bound of 1 ns is kept");
+    expect(!report.isValid(options), "latency guard: a trajectory over the latency bound is valid");
+}
+
+// Regression: with independent linear and angular limits the synchronized DoF of a section exceeded the limits of
+// the DoF whose share of the motion was small, by up to 1.69 times the velocity and 4.8 times the acceleration
+void testIndependentLinearAndAngularLimits()
+{
+    for (int seed = 0; seed < NUM_REGRESSION_SEEDS; ++seed) {
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+        QuietLogger logger;
+        TrajectoryGenerator generator(logger);
+        PlannedPath planned = planPath(generator, TestCase{ "independent limits" }, false, rng);
+
+        TrajectoryCheckOptions options = getCheckOptions();
+        TrajectoryCheckReport report = checkTrajectory(generator, planned, options);
+        std::string name = "independent limits seed " + std::to_string(seed);
+        expect(report.max_velocity_ratio <= 1.0 + options.limit_tolerance,
+               name + ": velocity ratio " + std::to_string(report.max_velocity_ratio));
+        expect(report.max_acceleration_ratio <= 1.0 + options.limit_tolerance,
+               name + ": acceleration ratio " + std::to_string(report.max_acceleration_ratio));
+    }
+}
+
+
+// Distance of the first num_dof values of position to the straight sections between the waypoints of path
+double calcDistanceToPath(const Path& path, const std::vector<double>& position, size_t num_dof)
+{
+    double min_distance = std::numeric_limits<double>::infinity();
+    for (size_t index = 0; index + 1 < path.size(); ++index) {
+        Point start = path.getPointValue(index);
+        Point end = path.getPointValue(index + 1);
+        double length_squared = 0.0;
+        double projection = 0.0;
+        for (size_t i = 0; i < num_dof; ++i) {
+            length_squared += std::pow(end[i] - start[i], 2);
+            projection += (position[i] - start[i]) * (end[i] - start[i]);
+        }
+        double fraction = length_squared > 0.0 ? std::clamp(projection / length_squared, 0.0, 1.0) : 0.0;
+        double distance_squared = 0.0;
+        for (size_t i = 0; i < num_dof; ++i) {
+            distance_squared += std::pow(position[i] - (start[i] + fraction * (end[i] - start[i])), 2);
+        }
+        min_distance = std::min(min_distance, std::sqrt(distance_squared));
+    }
+    return min_distance;
+}
+
+// A stop leaves the trajectory in its state at the stop time and comes to rest on the path
+void testStop()
+{
+    std::mt19937 rng(2);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    PlannedPath planned = planPath(generator, TestCase{ "stop" }, false, rng);
+
+    double duration = generator.getDuration();
+    for (int index = 0; index < NUM_STOPS; ++index) {
+        double time = duration * (index + 0.5) / NUM_STOPS;
+        std::string name = "stop at " + std::to_string(time);
+        StopTrajectory stop = generator.planStop(time);
+        expect(stop.getStartTime() == time, name + ": wrong start time");
+
+        Point pos, vel;
+        int id;
+        generator.calcPositionAndVelocity(time, pos, vel, id);
+        StopTrajectory::Values stop_pos, stop_vel;
+        stop.calcPositionAndVelocity(0.0, stop_pos, stop_vel);
+        double max_difference = 0.0;
+        for (size_t i = 0; i < stop.getNumDoF(); ++i) {
+            max_difference = std::max(max_difference, std::abs(stop_pos[i] - pos[i]));
+            max_difference = std::max(max_difference, std::abs(stop_vel[i] - vel[i]));
+        }
+        expect(max_difference <= 1e-9, name + ": starts off the trajectory by " + std::to_string(max_difference));
+
+        stop.calcPositionAndVelocity(stop.getDuration(), stop_pos, stop_vel);
+        double max_rest_velocity = 0.0;
+        for (size_t i = 0; i < stop.getNumDoF(); ++i) {
+            max_rest_velocity = std::max(max_rest_velocity, std::abs(stop_vel[i]));
+        }
+        expect(max_rest_velocity <= 1e-9, name + ": not at rest, velocity " + std::to_string(max_rest_velocity));
+        std::vector<double> rest_position(stop_pos.begin(), stop_pos.begin() + stop.getNumDoF());
+        double distance = calcDistanceToPath(planned.path, rest_position, stop.getNumDoF());
+        expect(distance <= 1e-6, name + ": rests " + std::to_string(distance) + " away from the path");
+    }
+}
+
+// The spliced trajectory continues with the unchanged motion of the other one after the blend at the junction
+void testSplice()
+{
+    std::mt19937 rng(3);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    PlannedPath planned = planPath(generator, TestCase{ "splice" }, false, rng);
+
+    // The other path starts at the last waypoint of the first one
+    TrajectoryGenerator other(logger);
+    Path other_path;
+    other_path.addPoint(planned.path.getPointValue(planned.path.size() - 1));
+    // planPath planned the first path from a copy of rng, the other path draws from its own sequence
+    std::mt19937 other_rng(13);
+    Path generated = generatePath(other_rng);
+    for (size_t index = 1; index < generated.size(); ++index) {
+        other_path.addPoint(generated.getPointValue(index));
+    }
+    std::vector<SectionConstraint> other_constraints = generateSectionConstraints(other_rng, false);
+    other.setBlendFallback(EXTEND_BLEND_DISTANCE);
+    other.resetPath(other_path, other_constraints,
+                    std::vector<SegmentConstraint>(NUM_WAYPOINTS - 2, SegmentConstraint(BLEND_DISTANCE)));
+
+    double duration = generator.getDuration();
+    double other_duration = other.getDuration();
+    double other_first_corner_time = 0.0;
+    for (const TrajectoryEvent& event : other.buildEventTimeline().getEvents()) {
+        if (event.type == WAYPOINT_REACHED) {
+            other_first_corner_time = event.time;
+            break;
+        }
+    }
+    std::vector<double> other_positions, other_velocities;
+    other.sampleTrajectory(SAMPLE_PERIOD, other_positions, other_velocities, 1);
+
+    generator.splice(other, SegmentConstraint(BLEND_DISTANCE));
+    double spliced_duration = generator.getDuration();
+    expect(spliced_duration <= duration + other_duration + 1e-9, "splice: the junction takes longer than a stop");
+    expect(generator.getDebugInfo().size() == 2 * NUM_WAYPOINTS - 3,
+           "splice: " + std::to_string(generator.getDebugInfo().size()) + " debug info entries");
+
+    // Everything after the first corner of the other trajectory is only shifted in time
+    double offset = spliced_duration - other_duration;
+    size_t num_dof = planned.path.getPointValue(0).size();
+    double max_difference = 0.0;
+    Point pos, vel;
+    int id;
+    for (size_t sample = 0; sample * num_dof < other_positions.size(); ++sample) {
+        double time = static_cast<double>(sample) * SAMPLE_PERIOD;
+        if (time < other_first_corner_time) {
+            continue;
+        }
+        generator.calcPositionAndVelocity(time + offset, pos, vel, id);
+        for (size_t i = 0; i < num_dof; ++i) {
+            max_difference = std::max(max_difference, std::abs(pos[i] - other_positions[sample * num_dof + i]));
+            max_difference = std::max(max_difference, std::abs(vel[i] - other_velocities[sample * num_dof + i]));
+        }
+    }
+    expect(max_difference <= 1e-9, "splice: the spliced motion differs by " + std::to_string(max_difference));
+
+    PlannedPath spliced;
+    spliced.path = planned.path;
+    for (size_t index = 1; index < other_path.size(); ++index) {
+        spliced.path.addPoint(other_path.getPointValue(index));
+    }
+    spliced.section_constraints = planned.section_constraints;
+    spliced.section_constraints.insert(spliced.section_constraints.end(), other_constraints.begin(),
+                                       other_constraints.end());
+    TrajectoryCheckOptions options = getCheckOptions();
+    TrajectoryCheckReport report = checkTrajectory(generator, spliced, options);
+    expect(report.isValid(options), "splice: the spliced trajectory is not valid");
+}
+
+// The error bounds of an export hold for every sample, not only for the points the export compared
+template <typename Scalar>
+void testPolynomialExport(double max_error_bound, const std::string& name)
+{
+    std::mt19937 rng(4);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    planPath(generator, TestCase{ name }, false, rng);
+    PolynomialTrajectory<Scalar> exported = generator.exportPolynomial<Scalar>();
+
+    expect(exported.getMaxPositionError() <= max_error_bound,
+           name + ": position error bound " + std::to_string(exported.getMaxPositionError()));
+    expect(exported.getMaxVelocityError() <= max_error_bound,
+           name + ": velocity error bound " + std::to_string(exported.getMaxVelocityError()));
+
+    size_t num_dof = exported.getNumDoF();
+    std::vector<Scalar> exported_pos(num_dof), exported_vel(num_dof);
+    Point pos, vel;
+    int id;
+    double max_position_error = 0.0;
+    double max_velocity_error = 0.0;
+    for (double time = 0.0; time <= generator.getDuration(); time += SAMPLE_PERIOD) {
+        generator.calcPositionAndVelocity(time, pos, vel, id);
+        exported.calcPositionAndVelocity(time, exported_pos.data(), exported_vel.data());
+        for (size_t i = 0; i < num_dof; ++i) {
+            max_position_error = std::max(max_position_error, std::abs(exported_pos[i] - pos[i]));
+            max_velocity_error = std::max(max_velocity_error, std::abs(exported_vel[i] - vel[i]));
+        }
+    }
+    // Rounding within a piece may exceed the bounds found at its start, middle and end by a few ulps
+    double slack = 8 * std::numeric_limits<Scalar>::epsilon();
+    expect(max_position_error <= exported.getMaxPositionError() + slack,
+           name + ": position error " + std::to_string(max_position_error) + " exceeds the bound");
+    expect(max_velocity_error <= exported.getMaxVelocityError() + slack,
+           name + ": velocity error " + std::to_string(max_velocity_error) + " exceeds the bound");
+}
+
+// The events match the reached waypoints and the motion of the phases they report
+void testEventTimeline()
+{
+    std::mt19937 rng(5);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    planPath(generator, TestCase{ "events" }, false, rng);
+
+    EventTimeline timeline = generator.buildEventTimeline();
+    const std::vector<TrajectoryEvent>& events = timeline.getEvents();
+    expect(std::is_sorted(events.begin(), events.end(),
+                          [](const TrajectoryEvent& first, const TrajectoryEvent& second) {
+                              return first.time < second.time;
+                          }),
+           "events: not in order of time");
+
+    size_t num_waypoints_reached = 0;
+    Point pos, vel, later_pos, later_vel;
+    int id;
+    for (size_t index = 0; index < events.size(); ++index) {
+        const TrajectoryEvent& event = events[index];
+        std::string name = "events: event " + std::to_string(index);
+        double next_time = index + 1 < events.size() ? events[index + 1].time : generator.getDuration();
+        if (event.type == WAYPOINT_REACHED) {
+            ++num_waypoints_reached;
+            if (index + 1 < events.size()) {
+                int passed = generator.getNumPassedWaypoints(event.time + EVENT_OFFSET);
+                expect(passed == event.waypoint_id, name + ": waypoint " + std::to_string(event.waypoint_id)
+                                                        + " reached, but " + std::to_string(passed) + " passed");
+            }
+        }
+        if (event.type != PHASE_CHANGE || next_time - event.time < 3 * EVENT_OFFSET) {
+            continue;
+        }
+        // The speed changes like the phase that begins
+        generator.calcPositionAndVelocity(event.time + EVENT_OFFSET, pos, vel, id);
+        generator.calcPositionAndVelocity(event.time + 2 * EVENT_OFFSET, later_pos, later_vel, id);
+        double speed_change = later_vel.norm() - vel.norm();
+        bool matches = event.phase == ACCELERATING ? speed_change > 0.0
+                       : event.phase == COASTING   ? std::abs(speed_change) <= 1e-9
+                                                   : speed_change < 0.0;
+        expect(matches, name + ": speed changes by " + std::to_string(speed_change) + " in phase "
+                            + std::to_string(static_cast<int>(event.phase)));
+    }
+    expect(num_waypoints_reached == NUM_WAYPOINTS - 1,
+           "events: " + std::to_string(num_waypoints_reached) + " waypoints reached");
+
+    // Advancing fires every event once, seeking back fires them again
+    class CountingListener : public EventListener {
+    public:
+        size_t num_events = 0;
+        void onEvent(const TrajectoryEvent&) override { ++num_events; }
+    };
+    CountingListener listener;
+    double duration = generator.getDuration();
+    for (double time = 0.0; time <= duration + EVENT_TICK; time += EVENT_TICK) {
+        timeline.advance(time, listener);
+    }
+    expect(listener.num_events == events.size() && timeline.getNumPendingEvents() == 0,
+           "events: " + std::to_string(listener.num_events) + " of " + std::to_string(events.size()) + " fired");
+    timeline.seek(-1.0);
+    expect(timeline.advance(duration + 1.0, listener) == events.size(), "events: seeking back lost events");
+}
+
+// Every thread count samples the same values as the evaluation of single times
+void testParallelSampling()
+{
+    std::mt19937 rng(6);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    planPath(generator, TestCase{ "parallel sampling" }, false, rng);
+
+    std::vector<double> positions, velocities, reference_positions, reference_velocities;
+    size_t num_samples = generator.sampleTrajectory(SAMPLE_PERIOD, reference_positions, reference_velocities, 1);
+    size_t num_dof = reference_positions.size() / num_samples;
+    expect(num_samples == static_cast<size_t>(std::floor(generator.getDuration() / SAMPLE_PERIOD)) + 1,
+           "parallel sampling: " + std::to_string(num_samples) + " samples");
+
+    Point pos, vel;
+    int id;
+    double max_difference = 0.0;
+    for (size_t sample = 0; sample < num_samples; ++sample) {
+        generator.calcPositionAndVelocity(static_cast<double>(sample) * SAMPLE_PERIOD, pos, vel, id);
+        for (size_t i = 0; i < num_dof; ++i) {
+            max_difference = std::max(max_difference, std::abs(pos[i] - reference_positions[sample * num_dof + i]));
+            max_difference = std::max(max_difference, std::abs(vel[i] - reference_velocities[sample * num_dof + i]));
+        }
+    }
+    expect(max_difference <= 1e-12, "parallel sampling: differs from the evaluation by "
+                                        + std::to_string(max_difference));
+
+    const size_t thread_counts[] = { 2, 3, 7 };
+    for (size_t num_threads : thread_counts) {
+        std::string name = "parallel sampling with " + std::to_string(num_threads) + " threads";
+        expect(generator.sampleTrajectory(SAMPLE_PERIOD, positions, velocities, num_threads) == num_samples,
+               name + ": wrong number of samples");
+        expect(positions == reference_positions && velocities == reference_velocities,
+               name + ": differs from one thread");
+    }
+}
+
+// The closest approach matches a dense scan of the evaluated positions
+void testDistanceQuery()
+{
+    std::mt19937 rng(7);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    planPath(generator, TestCase{ "distance query" }, false, rng);
+    DistanceQuery query = generator.buildDistanceQuery();
+    size_t num_dof = query.getNumDoF();
+    double duration = generator.getDuration();
+
+    // The waypoints were drawn from a copy of rng, the queries draw from their own sequence
+    std::mt19937 query_rng(17);
+    std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+    std::uniform_real_distribution<double> fraction(0.0, 1.0);
+    Point pos, vel;
+    int id;
+    for (int index = 0; index < NUM_QUERIES; ++index) {
+        std::string name = "distance query " + std::to_string(index);
+        std::vector<double> points(NUM_QUERY_POINTS * num_dof);
+        for (double& value : points) {
+            value = coordinate(query_rng);
+        }
+        double start_time = index == 0 ? 0.0 : duration * fraction(query_rng);
+        double end_time = index == 0 ? duration : start_time + (duration - start_time) * fraction(query_rng);
+
+        double brute_force_distance = std::numeric_limits<double>::infinity();
+        for (double time = start_time; time <= end_time; time += QUERY_SCAN_PERIOD) {
+            generator.calcPositionAndVelocity(time, pos, vel, id);
+            for (size_t point = 0; point < NUM_QUERY_POINTS; ++point) {
+                double distance_squared = 0.0;
+                for (size_t i = 0; i < num_dof; ++i) {
+                    distance_squared += std::pow(pos[i] - points[point * num_dof + i], 2);
+                }
+                brute_force_distance = std::min(brute_force_distance, std::sqrt(distance_squared));
+            }
+        }
+
+        DistanceQueryResult result = query.findClosestApproach(points, start_time, end_time);
+        // The scan misses the exact approach by at most half a scan step at the largest velocity
+        expect(result.distance <= brute_force_distance + 1e-9
+                   && brute_force_distance - result.distance <= MAX_QUERY_SCAN_ERROR,
+               name + ": " + std::to_string(result.distance) + " instead of "
+                   + std::to_string(brute_force_distance));
+        expect(result.time >= start_time && result.time <= end_time, name + ": approach outside the window");
+
+        generator.calcPositionAndVelocity(result.time, pos, vel, id);
+        double distance_squared = 0.0;
+        for (size_t i = 0; i < num_dof; ++i) {
+            distance_squared += std::pow(pos[i] - points[result.point_index * num_dof + i], 2);
+        }
+        expect(std::abs(std::sqrt(distance_squared) - result.distance) <= 1e-9,
+               name + ": the trajectory is not at the reported distance at the reported time");
+
+        double bound = (result.distance - MAX_QUERY_SCAN_ERROR) / 2;
+        expect(bound <= 0.0 || !query.findClosestApproach(points, start_time, end_time, bound).isFound(),
+               name + ": found an approach closer than the closest one");
+    }
+}
+
+// The tree finds the same segments as a linear scan, and every segment stays within its bounds
+void testSegmentBounds()
+{
+    std::mt19937 rng(8);
+    QuietLogger logger;
+    TrajectoryGenerator generator(logger);
+    planPath(generator, TestCase{ "segment bounds" }, false, rng);
+    const SegmentBoundsTree& tree = generator.getSegmentBounds();
+    const std::vector<SegmentBounds>& segments = tree.getSegments();
+    size_t num_dof = tree.getNumDoF();
+    double duration = generator.getDuration();
+
+    Point pos, vel;
+    int id;
+    double max_outside = 0.0;
+    for (const SegmentBounds& segment : segments) {
+        for (double time = segment.start_time; time <= segment.end_time; time += QUERY_SCAN_PERIOD) {
+            generator.calcPositionAndVelocity(time, pos, vel, id);
+            for (size_t i = 0; i < num_dof; ++i) {
+                max_outside = std::max({ max_outside, segment.box.min[i] - pos[i], pos[i] - segment.box.max[i] });
+            }
+        }
+    }
+    expect(max_outside <= 1e-9, "segment bounds: a position is " + std::to_string(max_outside) + " outside");
+
+    std::mt19937 query_rng(19);
+    std::uniform_real_distribution<double> coordinate(-1.0, 1.0);
+    std::uniform_real_distribution<double> extent(0.2, 1.0);
+    std::uniform_real_distribution<double> fraction(0.0, 1.0);
+    for (int index = 0; index < NUM_QUERIES; ++index) {
+        BoundingBox region(num_dof);
+        for (size_t i = 0; i < num_dof; ++i) {
+            region.min[i] = coordinate(query_rng);
+            region.max[i] = region.min[i] + extent(query_rng);
+        }
+        double start_time = duration * fraction(query_rng);
+        double end_time = start_time + (duration - start_time) * fraction(query_rng);
+
+        std::vector<size_t> found;
+        tree.findSegmentsInRegion(region, found, start_time, end_time);
+        std::vector<size_t> scanned;
+        for (size_t segment = 0; segment < segments.size(); ++segment) {
+            if (segments[segment].box.intersects(region) && segments[segment].end_time >= start_time
+                && segments[segment].start_time <= end_time) {
+                scanned.push_back(segment);
+            }
+        }
+        expect(found == scanned, "segment bounds query " + std::to_string(index) + ": found "
+                                     + std::to_string(found.size()) + " instead of " + std::to_string(scanned.size())
+                                     + " segments");
+    }
+}
+
+// Entries reach the sink in order, entries that find the buffer full are dropped and counted
+void testRingBufferLogger()
+{
+    class CollectingLogger : public Logger {
+    private:
+        mutable std::mutex mutex_;
+        mutable std::vector<std::string> messages_;
+
+    public:
+        void log(const std::string& message, MsgType) const override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            messages_.push_back(message);
+        }
+        bool isEnabled(MsgType) const override { return true; }
+        std::vector<std::string> getMessages() const
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return messages_;
+        }
+    };
+
+    CollectingLogger sink;
+    const LogRecord record{ BLEND_DISTANCE_CROPPED, Logger::WARNING, 3, -1, {} };
+    {
+        // The drain thread only runs on flush and destruction within the test
+        RingBufferLogger logger(sink, RING_BUFFER_CAPACITY, std::chrono::hours(1));
+        logger.flush();
+
+        for (size_t index = 0; index < 2 * RING_BUFFER_CAPACITY; ++index) {
+            logger.log(std::to_string(index));
+        }
+        logger.flush();
+        std::vector<std::string> messages = sink.getMessages();
+        expect(messages.size() == RING_BUFFER_CAPACITY,
+               "ring buffer logger: " + std::to_string(messages.size()) + " entries drained");
+        for (size_t index = 0; index < messages.size(); ++index) {
+            expect(messages[index] == std::to_string(index), "ring buffer logger: entry " + std::to_string(index)
+                                                                 + " drained as " + messages[index]);
+        }
+        expect(logger.getNumDroppedEntries() == RING_BUFFER_CAPACITY,
+               "ring buffer logger: " + std::to_string(logger.getNumDroppedEntries()) + " entries dropped");
+
+        // Records are formatted by the drain thread, long messages are truncated
+        logger.logRecord(record);
+        logger.log(std::string(2 * RingBufferLogger::MAX_MESSAGE_LENGTH, 'x'));
+    }
+    std::vector<std::string> messages = sink.getMessages();
+    expect(messages.size() == RING_BUFFER_CAPACITY + 2, "ring buffer logger: the destructor did not drain");
+    if (messages.size() == RING_BUFFER_CAPACITY + 2) {
+        expect(messages[RING_BUFFER_CAPACITY] == formatLogRecord(record),
+               "ring buffer logger: record drained as " + messages[RING_BUFFER_CAPACITY]);
+        expect(messages.back() == std::string(RingBufferLogger::MAX_MESSAGE_LENGTH, 'x'),
+               "ring buffer logger: long message not truncated");
+    }
+}
+
+}  // namespace
+
+int main()
+{
+    std::vector<TestCase> test_cases;
+    for (bool fixed_dof : { false, true }) {
+        for (bool lazy_blending : { false, true }) {
+            std::string name = std::string(fixed_dof ? "fixed" : "dynamic") + (lazy_blending ? " lazy" : " eager");
+            test_cases.push_back({ name, fixed_dof, lazy_blending });
+            test_cases.push_back({ name + " per DoF limits", fixed_dof, lazy_blending, true });
+            test_cases.push_back({ name + " slerp", fixed_dof, lazy_blending, false, true });
+            test_cases.push_back({ name + " blend optimization", fixed_dof, lazy_blending, false, false, true });
+        }
+    }
+
+    for (const TestCase& test_case : test_cases) {
+        for (int seed = 0; seed < NUM_SEEDS; ++seed) {
+            runCase(test_case, seed);
+        }
+    }
+    testLatencyGuard();
+    testIndependentLinearAndAngularLimits();
+    testStop();
+    testSplice();
+    testPolynomialExport<double>(1e-9, "double export");
+    testPolynomialExport<float>(1e-4, "float export");
+    testEventTimeline();
+    testParallelSampling();
+    testDistanceQuery();
+    testSegmentBounds();
+    testRingBufferLogger();
+
+    if (num_failures > 0) {
+        std::printf("%d checks failed\n", num_failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
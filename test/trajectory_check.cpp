@@ -0,0 +1,291 @@
+#include "trajectory_check.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+using namespace SOTG;
+
+namespace {
+
+// Steps of the dense reference integral of the velocity over one sample period
+constexpr int NUM_REFERENCE_STEPS = 8;
+// Continuity is evaluated this far before and after a segment boundary
+constexpr double BOUNDARY_OFFSET = 1e-9;
+
+// Time interval of a blend of the event timeline and the section before its corner, the corner is the waypoint
+// after it
+struct Blend {
+    double start_time;
+    double end_time;
+    size_t pre_section_id;
+};
+
+double calcDifferenceNorm(const Point& first, const Point& second, size_t num_dof);
+double calcLimitRatio(const std::vector<double>& value, size_t orientation_index, size_t num_dof,
+                      double max_linear, double max_angular, const std::vector<double>& max_per_dof);
+SectionConstraint calcBlendLimits(const SectionConstraint& pre, const SectionConstraint& post);
+std::vector<Blend> collectBlends(const EventTimeline& timeline);
+double calcAllowedDeviation(const std::map<std::string, double>& debug_info, double max_blend_deviation);
+
+// Norm of the difference of the first num_dof values
+double calcDifferenceNorm(const Point& first, const Point& second, size_t num_dof)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < num_dof; ++i) {
+        sum += std::pow(first[i] - second[i], 2);
+    }
+    return std::sqrt(sum);
+}
+
+// Largest ratio of the linear and angular magnitude and of the single DoF of value to their limits
+double calcLimitRatio(const std::vector<double>& value, size_t orientation_index, size_t num_dof,
+                      double max_linear, double max_angular, const std::vector<double>& max_per_dof)
+{
+    auto calcRatio = [](double magnitude, double limit) { return magnitude < 1e-12 ? 0.0 : magnitude / limit; };
+
+    double linear_magnitude = 0.0;
+    double angular_magnitude = 0.0;
+    double ratio = 0.0;
+    for (size_t i = 0; i < num_dof; ++i) {
+        if (i < orientation_index) {
+            linear_magnitude += std::pow(value[i], 2);
+        } else {
+            angular_magnitude += std::pow(value[i], 2);
+        }
+        if (i < max_per_dof.size()) {
+            ratio = std::max(ratio, calcRatio(std::abs(value[i]), max_per_dof[i]));
+        }
+    }
+    ratio = std::max(ratio, calcRatio(std::sqrt(linear_magnitude), max_linear));
+    return std::max(ratio, calcRatio(std::sqrt(angular_magnitude), max_angular));
+}
+
+// A blend may reach the higher magnitudes and velocities of both sections, but has to keep the stricter per DoF
+// acceleration limit. A DoF without velocity limit in one of the sections is unlimited during the blend.
+SectionConstraint calcBlendLimits(const SectionConstraint& pre, const SectionConstraint& post)
+{
+    std::vector<double> acc_per_dof
+        = pre.getAccelerationPerDoF().empty() ? post.getAccelerationPerDoF() : pre.getAccelerationPerDoF();
+    if (!pre.getAccelerationPerDoF().empty() && !post.getAccelerationPerDoF().empty()) {
+        for (size_t i = 0; i < acc_per_dof.size(); ++i) {
+            acc_per_dof[i] = std::min(pre.getAccelerationPerDoF()[i], post.getAccelerationPerDoF()[i]);
+        }
+    }
+    std::vector<double> vel_per_dof;
+    if (!pre.getVelocityPerDoF().empty() && !post.getVelocityPerDoF().empty()) {
+        vel_per_dof = pre.getVelocityPerDoF();
+        for (size_t i = 0; i < vel_per_dof.size(); ++i) {
+            vel_per_dof[i] = std::max(pre.getVelocityPerDoF()[i], post.getVelocityPerDoF()[i]);
+        }
+    }
+
+    return SectionConstraint(std::max(pre.getAccelerationMagnitudeLinear(), post.getAccelerationMagnitudeLinear()),
+                             std::max(pre.getAccelerationMagnitudeAngular(), post.getAccelerationMagnitudeAngular()),
+                             std::max(pre.getVelocityMagnitudeLinear(), post.getVelocityMagnitudeLinear()),
+                             std::max(pre.getVelocityMagnitudeAngular(), post.getVelocityMagnitudeAngular()),
+                             acc_per_dof, vel_per_dof);
+}
+
+// Blends in order of time, blends without duration have no events
+std::vector<Blend> collectBlends(const EventTimeline& timeline)
+{
+    std::vector<Blend> blends;
+    for (const TrajectoryEvent& event : timeline.getEvents()) {
+        if (event.type == BLEND_START) {
+            blends.push_back({ event.time, event.time, event.section_id });
+        } else if (event.type == BLEND_END) {
+            blends.back().end_time = event.time;
+        }
+    }
+    return blends;
+}
+
+// A blend extended by the fallback deviates by its extension further than requested
+double calcAllowedDeviation(const std::map<std::string, double>& debug_info, double max_blend_deviation)
+{
+    if (max_blend_deviation >= 0.0) {
+        return max_blend_deviation;
+    }
+    return std::max(debug_info.at("requested_blend_dist"), debug_info.at("pre_blend_dist"));
+}
+
+}  // namespace
+
+bool TrajectoryCheckReport::isContinuous(const TrajectoryCheckOptions& options) const
+{
+    return max_position_jump <= options.continuity_tolerance && max_velocity_jump <= options.continuity_tolerance;
+}
+
+bool TrajectoryCheckReport::isWithinLimits(const TrajectoryCheckOptions& options) const
+{
+    double max_ratio = 1.0 + options.limit_tolerance;
+    return max_velocity_ratio <= max_ratio && max_acceleration_ratio <= max_ratio
+           && max_blend_deviation_ratio <= max_ratio;
+}
+
+bool TrajectoryCheckReport::isConsistent(const TrajectoryCheckOptions& options) const
+{
+    return max_integration_error <= options.integration_tolerance;
+}
+
+bool TrajectoryCheckReport::isFastEnough(const TrajectoryCheckOptions& options) const
+{
+    if (options.max_evaluation_latency_ns == 0) {
+        return true;
+    }
+    uint64_t latency_ns = evaluation_latency.getQuantileUpperBoundNs(options.latency_quantile);
+    return latency_ns <= options.max_evaluation_latency_ns;
+}
+
+bool TrajectoryCheckReport::isValid(const TrajectoryCheckOptions& options) const
+{
+    return isContinuous(options) && isWithinLimits(options) && isConsistent(options) && isFastEnough(options);
+}
+
+TrajectoryCheckReport checkTrajectory(TrajectoryGenerator& generator, const PlannedPath& planned,
+                                      const TrajectoryCheckOptions& options)
+{
+    if (!(options.sample_period > 0.0)) {
+        throw std::runtime_error("checkTrajectory: The sample period must be positive");
+    }
+
+    TrajectoryCheckReport report;
+    double duration = generator.getDuration();
+    const std::vector<SegmentBounds> segments = generator.getSegmentBounds().getSegments();
+    if (segments.empty()) {
+        return report;
+    }
+
+    const Point first_point = planned.path.getPointValue(0);
+    size_t num_dof = first_point.size();
+    int orientation_index = first_point.getOrientationIndex();
+    size_t linear_dof = orientation_index == -1 ? num_dof : static_cast<size_t>(orientation_index);
+    size_t num_checked_dof = planned.slerp ? linear_dof : num_dof;
+
+    // Continuity of the evaluated motion across the boundaries of the segments with duration
+    Point pos_before, vel_before, pos_after, vel_after;
+    int id;
+    for (size_t index = 1; index < segments.size(); ++index) {
+        double boundary = segments[index].start_time;
+        generator.calcPositionAndVelocity(boundary - BOUNDARY_OFFSET, pos_before, vel_before, id);
+        generator.calcPositionAndVelocity(boundary + BOUNDARY_OFFSET, pos_after, vel_after, id);
+        report.max_position_jump
+            = std::max(report.max_position_jump, calcDifferenceNorm(pos_before, pos_after, num_checked_dof));
+        report.max_velocity_jump
+            = std::max(report.max_velocity_jump, calcDifferenceNorm(vel_before, vel_after, num_checked_dof));
+        ++report.num_segment_boundaries;
+    }
+
+    // Closest approach of every blend to its corner, the debug info has one entry per corner in order of the
+    // sections
+    EventTimeline timeline = generator.buildEventTimeline();
+    std::vector<Blend> blends = collectBlends(timeline);
+    DistanceQuery distance_query = generator.buildDistanceQuery();
+    const std::vector<std::map<std::string, double>>& debug_info = generator.getDebugInfo();
+    for (const Blend& blend : blends) {
+        const Point corner = planned.path.getPointValue(blend.pre_section_id + 1);
+        std::vector<double> corner_position(linear_dof);
+        for (size_t i = 0; i < linear_dof; ++i) {
+            corner_position[i] = corner[i];
+        }
+        double deviation
+            = distance_query.findClosestApproach(corner_position, blend.start_time, blend.end_time).distance;
+        double allowed_deviation
+            = calcAllowedDeviation(debug_info.at(blend.pre_section_id), planned.max_blend_deviation);
+        double ratio = deviation < 1e-12 ? 0.0 : deviation / allowed_deviation;
+        report.max_blend_deviation_ratio = std::max(report.max_blend_deviation_ratio, ratio);
+        ++report.num_blends;
+    }
+
+    // Waypoints count as reached at the end of their section, within a blend both of its sections apply
+    std::vector<double> waypoint_times;
+    for (const TrajectoryEvent& event : timeline.getEvents()) {
+        if (event.type == WAYPOINT_REACHED) {
+            waypoint_times.push_back(event.time);
+        }
+    }
+
+    // Limits and consistency of the sampled states, accelerations and integrals only within one segment
+    size_t segment_index = 0;
+    size_t blend_index = 0;
+    size_t previous_segment_index = segments.size();
+    Point pos, vel, previous_pos, previous_vel, step_pos, step_vel;
+    std::vector<double> velocity(num_dof), acc(num_dof), integrated_pos(num_dof), step_start_vel(num_dof);
+    double previous_time = 0.0;
+    size_t num_periods = static_cast<size_t>(std::floor(duration / options.sample_period));
+    for (size_t sample = 0; sample <= num_periods; ++sample) {
+        double time = static_cast<double>(sample) * options.sample_period;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        generator.calcPositionAndVelocity(time, pos, vel, id);
+        std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - start;
+        report.evaluation_latency.record(static_cast<uint64_t>(latency.count()));
+        ++report.num_samples;
+
+        while (segment_index + 1 < segments.size() && segments[segment_index + 1].start_time <= time) {
+            ++segment_index;
+        }
+        while (blend_index < blends.size() && blends[blend_index].end_time < time) {
+            ++blend_index;
+        }
+        SectionConstraint limits = planned.section_constraints.front();
+        if (blend_index < blends.size() && blends[blend_index].start_time <= time) {
+            size_t pre_section_id = blends[blend_index].pre_section_id;
+            limits = calcBlendLimits(planned.section_constraints.at(pre_section_id),
+                                     planned.section_constraints.at(pre_section_id + 1));
+        } else {
+            size_t section_id = static_cast<size_t>(
+                std::upper_bound(waypoint_times.begin(), waypoint_times.end(), time) - waypoint_times.begin());
+            limits = planned.section_constraints.at(std::min(section_id, planned.section_constraints.size() - 1));
+        }
+
+        for (size_t i = 0; i < num_dof; ++i) {
+            velocity[i] = vel[i];
+        }
+        report.max_velocity_ratio = std::max(
+            report.max_velocity_ratio,
+            calcLimitRatio(velocity, linear_dof, num_checked_dof, limits.getVelocityMagnitudeLinear(),
+                           limits.getVelocityMagnitudeAngular(), limits.getVelocityPerDoF()));
+
+        if (previous_segment_index == segment_index) {
+            double dt = time - previous_time;
+            for (size_t i = 0; i < num_dof; ++i) {
+                acc[i] = (vel[i] - previous_vel[i]) / dt;
+            }
+            report.max_acceleration_ratio = std::max(
+                report.max_acceleration_ratio,
+                calcLimitRatio(acc, linear_dof, num_checked_dof, limits.getAccelerationMagnitudeLinear(),
+                               limits.getAccelerationMagnitudeAngular(), limits.getAccelerationPerDoF()));
+
+            // Trapezoidal integral of the velocity with a step much smaller than the sample period
+            for (size_t i = 0; i < num_dof; ++i) {
+                integrated_pos[i] = previous_pos[i];
+                step_start_vel[i] = previous_vel[i];
+            }
+            for (int step = 1; step <= NUM_REFERENCE_STEPS; ++step) {
+                generator.calcPositionAndVelocity(previous_time + dt * step / NUM_REFERENCE_STEPS, step_pos,
+                                                  step_vel, id);
+                for (size_t i = 0; i < num_dof; ++i) {
+                    integrated_pos[i] += (step_start_vel[i] + step_vel[i]) * (dt / (2 * NUM_REFERENCE_STEPS));
+                    step_start_vel[i] = step_vel[i];
+                }
+            }
+            double error = 0.0;
+            for (size_t i = 0; i < num_checked_dof; ++i) {
+                error += std::pow(pos[i] - integrated_pos[i], 2);
+            }
+            report.max_integration_error = std::max(report.max_integration_error, std::sqrt(error));
+        }
+
+        previous_segment_index = segment_index;
+        previous_pos = pos;
+        previous_vel = vel;
+        previous_time = time;
+    }
+
+    return report;
+}
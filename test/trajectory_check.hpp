@@ -0,0 +1,77 @@
+// Checks of the properties every planned trajectory has to keep, regardless of the solver that calculated it. Only
+// the public interface of the trajectory generator is used, so the checks guard changes of the solver.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "sotg/sotg.hpp"
+
+// Sampling and pass criteria of checkTrajectory
+struct TrajectoryCheckOptions {
+    // The trajectory is evaluated every sample_period seconds
+    double sample_period = 1e-3;
+
+    // Largest jump of position and velocity between adjacent segments
+    double continuity_tolerance = 1e-6;
+    // Relative tolerance of the velocity, acceleration and blend deviation limits
+    double limit_tolerance = 1e-6;
+    // Largest difference between the evaluated positions and the ones integrated from the evaluated velocities
+    double integration_tolerance = 1e-6;
+
+    // Latency regression guard, the given quantile of the evaluation latency must not exceed
+    // max_evaluation_latency_ns. Zero disables the guard.
+    uint64_t max_evaluation_latency_ns = 0;
+    double latency_quantile = 0.99;
+};
+
+// Input the checked trajectory was planned from
+struct PlannedPath {
+    SOTG::Path path;
+    std::vector<SOTG::SectionConstraint> section_constraints;
+    // Maximum deviation of blend optimization, negative if it is disabled
+    double max_blend_deviation = -1.0;
+    // Orientations interpolated as quaternions are no plain values, only the linear DoF are checked then
+    bool slerp = false;
+};
+
+struct TrajectoryCheckReport {
+    size_t num_samples = 0;
+    size_t num_segment_boundaries = 0;
+    size_t num_blends = 0;
+
+    // Largest jump of the evaluated motion across the boundary of two segments
+    double max_position_jump = 0.0;
+    double max_velocity_jump = 0.0;
+
+    // Largest velocity and acceleration relative to the limits of the section constraints, at most one if all
+    // limits are kept. Accelerations are finite differences of the sampled velocities within one segment.
+    double max_velocity_ratio = 0.0;
+    double max_acceleration_ratio = 0.0;
+
+    // Largest distance of a blend to its corner relative to the allowed one. That is the maximum deviation of
+    // blend optimization if enabled and the blend distance the blend was planned with otherwise, which is the
+    // extended one for blends extended by EXTEND_BLEND_DISTANCE.
+    double max_blend_deviation_ratio = 0.0;
+
+    // Largest difference between the position change over a sample period and the dense reference integral of the
+    // velocity over it
+    double max_integration_error = 0.0;
+
+    // Latency of calcPositionAndVelocity over all samples
+    SOTG::LatencyHistogram evaluation_latency;
+
+    bool isContinuous(const TrajectoryCheckOptions& options) const;
+    bool isWithinLimits(const TrajectoryCheckOptions& options) const;
+    bool isConsistent(const TrajectoryCheckOptions& options) const;
+    bool isFastEnough(const TrajectoryCheckOptions& options) const;
+    bool isValid(const TrajectoryCheckOptions& options) const;
+};
+
+// Samples the whole trajectory of generator, which was planned from planned by a single resetPath, and checks
+// continuity between segments, the limits of the constraints, the blend deviations and positions that integrate
+// the velocities
+TrajectoryCheckReport checkTrajectory(SOTG::TrajectoryGenerator& generator, const PlannedPath& planned,
+                                      const TrajectoryCheckOptions& options);